@@ -2,12 +2,12 @@
 
 void task1(void)
 {
-    printf("task1 running!\r\n");
+    bsp_printf("task1 running!\r\n");
 }
 
 void task2(void)
 {
-    printf("task2 running!\r\n");
+    bsp_printf("task2 running!\r\n");
 }
 
 void app_task_init(void)
@@ -3,15 +3,39 @@
 #include "app_task.h"
 #include "msh_task.h"
 
+#if BSP_FAST_BOOT
+// 快速启动时推迟的初始化，第一次调度时执行一次后挂起
+static void main_boot_deferred(void)
+{
+	delay_calibrate();
+	msh_task_boot_deferred();
+	mtos_task_show();
+	bsp_boot_mark("deferred");
+	mtos_task_suspend("boot");
+}
+#endif
+
 int main(void)
 {
 	bsp_sys_init();
 	mtos_init();
+	mtos_task_create("log", bsp_log_process, NULL, 0);
+	mtos_task_create("clk", bsp_clk_process, NULL, 0);
+	bsp_boot_mark("mtos");
 	msh_task_init();
+	bsp_boot_mark("msh");
 	app_task_init();
+	bsp_boot_mark("app");
+#if BSP_FAST_BOOT
+	mtos_task_create("boot", main_boot_deferred, NULL, 0);
+#else
 	mtos_task_show();
+	bsp_boot_mark("show");
+#endif
+	bsp_boot_mark("dispatch"); // 之后立即进入第一次调度
 	while (1)
 	{
 		mtos_task_schedule();
+		bsp_pwr_idle(mtos_task_next_deadline); // 没有任务到期时休眠
 	}
 }
@@ -1,38 +1,52 @@
 
 #include "msh.h"
+#include "msh_rpc.h"
+#include "msh_stream.h"
 #include "stm8s.h"
 
 // 外部命令段边界（由链接脚本定义）
 const msh_cmd_t *__msh_cmd_start;
 const msh_cmd_t *__msh_cmd_end;
 
-// MSH终端状态数据
-static struct
+// MSH会话状态数据，每个会话对应一个串口
+struct msh_session
 {
     char cmd_buf[MSH_CMD_MAX_LENGTH]; // 命令缓冲区
     uint16_t cmd_len;                 // 当前命令长度
-    char *argv[MSH_ARG_MAX_COUNT];    // 参数列表
-    int argc;                         // 参数数量
 
     // 历史命令相关
     char history[MSH_HISTORY_MAX_COUNT][MSH_CMD_MAX_LENGTH];
     uint8_t history_count; // 历史命令数量
     int8_t history_index;  // 当前历史命令索引
 
-    // 接收缓冲区相关
-    uint8_t recv_buf[MSH_UART_BUFFER_SIZE];
-    uint16_t recv_head;
-    uint16_t recv_tail;
-} msh_data = {0};
+    // 从驱动批量读取的输入（接收缓冲区由串口驱动维护）
+    uint8_t rx_buf[MSH_RX_CHUNK_SIZE];
+    uint8_t rx_len;
+    uint8_t rx_pos;
+
+    msh_write_t write; // 输出函数，为NULL时使用默认标准输出
+    msh_read_t read;   // 输入函数
+    uint8_t enabled;   // 会话是否已启用
+};
+
+static msh_session_t msh_sessions[MSH_SESSION_NUM];
+static msh_session_t *msh_cur = &msh_sessions[0]; // 当前正在处理的会话
+
+// 命令执行状态（命令同步执行，所有会话共用）
+static struct
+{
+    uint8_t exec_depth;                      // 命令嵌套执行深度（脚本中调用脚本）
+    msh_arg_val_t argval[MSH_ARG_MAX_COUNT]; // 按命令声明解析后的参数
+} msh_exec = {0};
 
 // 声明内部函数
-static void msh_parse_command(void);
+static int msh_parse_command(char *line, char **argv);
 static void msh_execute_command(void);
 static void msh_print_prompt(void);
 static void msh_add_history(const char *cmd);
 static void msh_handle_special_key(uint8_t c);
 static void msh_complete_command(void);
-static uint16_t msh_get_recv_count(void);
+static uint8_t msh_get_recv_count(void);
 static uint8_t msh_read_char(void);
 
 // 内置echo命令
@@ -40,25 +54,33 @@ int msh_cmd_echo(int argc, char **argv)
 {
     for (int i = 1; i < argc; i++)
     {
-        printf("%s ", argv[i]);
+        bsp_printf("%s ", argv[i]);
     }
-    printf("\r\n");
+    bsp_printf("\r\n");
     return 0;
 }
 
-// 内置help命令
-int msh_cmd_help(int argc, char **argv)
+// help命令输出生成函数，每次输出一行
+static uint8_t msh_help_gen(msh_stream_ctx_t *ctx, char *buf, uint8_t size)
 {
     const msh_cmd_t *cmd;
 
-    printf("Available commands:\r\n");
-    for (cmd = __msh_cmd_start; cmd < __msh_cmd_end; cmd++)
+    if (ctx->index == 0)
     {
-        if (cmd->name && cmd->func)
-        {
-            printf("  %-10s - %s\r\n", cmd->name, cmd->desc);
-        }
+        return (uint8_t)bsp_snprintf(buf, size, "Available commands:\r\n");
     }
+    cmd = msh_cmd_get((uint8_t)(ctx->index - 1));
+    if (cmd == NULL)
+    {
+        return 0;
+    }
+    return (uint8_t)bsp_snprintf(buf, size, "  %-10s - %s\r\n", cmd->name, cmd->desc);
+}
+
+// 内置help命令
+int msh_cmd_help(int argc, char **argv)
+{
+    msh_stream_start(msh_help_gen, 0, 0, msh_stream_page_opt(argc, argv));
     return 0;
 }
 
@@ -66,123 +88,407 @@ int msh_cmd_help(int argc, char **argv)
 int msh_cmd_clear(int argc, char **argv)
 {
     // 发送清屏ESC序列
-    printf("\033[2J\033[1;1H");
+    bsp_printf("\033[2J\033[1;1H");
     return 0;
 }
 
-// 获取接收缓冲区数据量
-static uint16_t msh_get_recv_count(void)
+// 获取可读取的数据量，不足2字节时（方向键序列需要预读）从驱动补充
+static uint8_t msh_get_recv_count(void)
 {
-    uint16_t count = 0;
-    if (msh_data.recv_head >= msh_data.recv_tail)
-    {
-        count = msh_data.recv_head - msh_data.recv_tail;
-    }
-    else
+    uint8_t n = msh_cur->rx_len - msh_cur->rx_pos;
+
+    if (n < 2)
     {
-        count = MSH_UART_BUFFER_SIZE - msh_data.recv_tail + msh_data.recv_head;
+        if (n > 0)
+        {
+            msh_cur->rx_buf[0] = msh_cur->rx_buf[msh_cur->rx_pos];
+        }
+        msh_cur->rx_pos = 0;
+        msh_cur->rx_len = n + msh_cur->read(&msh_cur->rx_buf[n], MSH_RX_CHUNK_SIZE - n);
     }
-    return count;
+    return msh_cur->rx_len - msh_cur->rx_pos;
 }
 
-// 从接收缓冲区读取一个字符
+// 读取一个字符，调用前需确认msh_get_recv_count()不为0
 static uint8_t msh_read_char(void)
 {
-    uint8_t c = msh_data.recv_buf[msh_data.recv_tail];
-    msh_data.recv_tail = (msh_data.recv_tail + 1) % MSH_UART_BUFFER_SIZE;
-    return c;
+    return msh_cur->rx_buf[msh_cur->rx_pos++];
 }
 
-// MSH终端初始化
-void msh_init(void)
+// 默认输入：从控制台串口读取
+static uint8_t msh_console_read(uint8_t *buf, uint8_t len)
+{
+    return uart_read(UART_CONSOLE_PORT, buf, len);
+}
+
+// 切换当前会话，标准输出随之切换到该会话的串口，返回之前的会话
+msh_session_t *msh_session_switch(msh_session_t *session)
+{
+    msh_session_t *prev = msh_cur;
+
+    msh_cur = session;
+    uart_set_stdout_hook(session->write);
+    return prev;
+}
+
+// 获取当前会话
+msh_session_t *msh_session_current(void)
+{
+    return msh_cur;
+}
+
+// 按编号获取会话
+msh_session_t *msh_session_get(uint8_t id)
+{
+    return (id < MSH_SESSION_NUM) ? &msh_sessions[id] : NULL;
+}
+
+// 启动会话：清空会话状态并输出欢迎信息
+void msh_session_init(uint8_t id, msh_write_t write, msh_read_t read)
 {
+    msh_session_t *session = msh_session_get(id);
+
+    if (session == NULL)
+    {
+        return;
+    }
+
     // 初始化缓冲区和变量
-    msh_data.cmd_len = 0;
-    msh_data.argc = 0;
-    msh_data.history_count = 0;
-    msh_data.history_index = -1;
-    msh_data.recv_head = 0;
-    msh_data.recv_tail = 0;
-    memset(msh_data.cmd_buf, 0, MSH_CMD_MAX_LENGTH);
-    memset(msh_data.argv, 0, sizeof(msh_data.argv));
-    memset(msh_data.history, 0, sizeof(msh_data.history));
-
-    // 打印欢迎信息
-    printf("Welcome to MSH Terminal!!\r\n");
-    printf("Build: %s\r\n", __DATE__);
+    session->enabled = 0;
+    session->cmd_len = 0;
+    session->history_count = 0;
+    session->history_index = -1;
+    session->rx_len = 0;
+    session->rx_pos = 0;
+    session->write = write;
+    session->read = (read != NULL) ? read : msh_console_read;
+    memset(session->cmd_buf, 0, MSH_CMD_MAX_LENGTH);
+    memset(session->history, 0, sizeof(session->history));
+    session->enabled = 1;
+
+#if !BSP_FAST_BOOT
+    msh_banner(id); // 快速启动时由后台任务打印
+#endif
+}
+
+// 在指定会话打印欢迎信息和提示符
+void msh_banner(uint8_t id)
+{
+    msh_session_t *session = msh_session_get(id);
+    msh_session_t *prev;
+
+    if (session == NULL || !session->enabled)
+    {
+        return;
+    }
+    prev = msh_session_switch(session);
+    bsp_printf("Welcome to MSH Terminal!!\r\n");
+    bsp_printf("Build: %s\r\n", __DATE__);
     msh_print_prompt();
+    msh_session_switch(prev);
+}
+
+// MSH终端初始化，会话0使用默认标准输出
+void msh_init(void)
+{
+    msh_exec.exec_depth = 0;
+    msh_session_init(0, NULL, NULL);
 }
 
 // 打印命令提示符
 static void msh_print_prompt(void)
 {
-    printf("msh> ");
+    bsp_printf("msh> ");
+}
+
+// 打印命令提示符（供流式输出结束等场合使用）
+void msh_prompt(void)
+{
+    msh_print_prompt();
+}
+
+// 转义字符转换
+static char msh_unescape(char c)
+{
+    switch (c)
+    {
+    case 'n':
+        return '\n';
+    case 'r':
+        return '\r';
+    case 't':
+        return '\t';
+    case 'e':
+        return 0x1B;
+    default:
+        return c;
+    }
 }
 
 // 解析命令行
-static void msh_parse_command(void)
+// 以空格或Tab分隔参数，连续空白视为一个分隔符；
+// 支持双引号/单引号包含空白，双引号内和引号外支持反斜杠转义，单引号内按原样保留
+static int msh_parse_command(char *line, char **argv)
 {
-    msh_data.argc = 0;
-    memset(msh_data.argv, 0, sizeof(msh_data.argv));
+    char *src = line; // 读指针
+    char *dst = line; // 写指针，去掉引号和转义后原地写回
+    char quote;
+    int argc = 0;
 
-    // 跳过前导空格
-    uint16_t i = 0;
-    while (i < msh_data.cmd_len && msh_data.cmd_buf[i] == ' ')
+    while (argc < MSH_ARG_MAX_COUNT)
     {
-        i++;
+        // 跳过空白
+        while (*src == ' ' || *src == '\t')
+        {
+            src++;
+        }
+        if (*src == '\0')
+        {
+            break;
+        }
+
+        argv[argc++] = dst;
+        quote = 0;
+
+        // 找到参数结束（引号外的空白或结束）
+        while (*src != '\0')
+        {
+            char c = *src;
+
+            if (quote == 0 && (c == ' ' || c == '\t'))
+            {
+                break;
+            }
+            if (c == quote)
+            {
+                quote = 0; // 引号结束
+                src++;
+                continue;
+            }
+            if (quote == 0 && (c == '"' || c == '\''))
+            {
+                quote = c; // 引号开始
+                src++;
+                continue;
+            }
+            if (c == '\\' && quote != '\'' && src[1] != '\0')
+            {
+                c = msh_unescape(*++src);
+            }
+            *dst++ = c;
+            src++;
+        }
+
+        // 先越过分隔符再写结束符，写指针不会超过读指针
+        if (*src != '\0')
+        {
+            src++;
+        }
+        *dst++ = '\0';
     }
+    return argc;
+}
+
+// 在引号外的第一个';'处截断命令行，返回剩余部分，没有';'时返回NULL
+static char *msh_split_line(char *line)
+{
+    char quote = 0;
 
-    // 解析参数
-    while (i < msh_data.cmd_len && msh_data.argc < MSH_ARG_MAX_COUNT)
+    for (; *line != '\0'; line++)
     {
-        msh_data.argv[msh_data.argc++] = &msh_data.cmd_buf[i];
+        if (*line == '\\' && quote != '\'' && line[1] != '\0')
+        {
+            line++; // 跳过转义字符
+        }
+        else if (quote != 0)
+        {
+            if (*line == quote)
+            {
+                quote = 0;
+            }
+        }
+        else if (*line == '"' || *line == '\'')
+        {
+            quote = *line;
+        }
+        else if (*line == ';')
+        {
+            *line = '\0';
+            return line + 1;
+        }
+    }
+    return NULL;
+}
+
+// 执行一行命令，多条命令以';'分隔，line会被原地修改
+void msh_exec_line(char *line)
+{
+    char *argv[MSH_ARG_MAX_COUNT];
+    const msh_cmd_t *cmd;
+    char *next;
+    int argc;
+    int ret;
+
+    // 限制嵌套深度，防止脚本互相调用导致栈溢出
+    if (msh_exec.exec_depth >= MSH_EXEC_DEPTH_MAX)
+    {
+        bsp_printf("Nesting too deep\r\n");
+        return;
+    }
+    msh_exec.exec_depth++;
+
+    while (line != NULL)
+    {
+        next = msh_split_line(line);
+        argc = msh_parse_command(line, argv);
+        line = next;
+        if (argc == 0)
+        {
+            continue;
+        }
+
+        // 查找并执行命令
+        cmd = msh_cmd_find(argv[0]);
+        if (cmd == NULL)
+        {
+            bsp_printf("Command not found: %s\r\n", argv[0]);
+            continue;
+        }
+        // 按声明检查参数，失败时打印用法
+        if (msh_cmd_invoke(cmd, argc, argv, &ret) == MSH_EXEC_ARG_ERROR)
+        {
+            msh_arg_print_usage(cmd->name, cmd->args, cmd->args_num);
+        }
+    }
 
-        // 找到参数结束（空格或结束）
-        while (i < msh_data.cmd_len && msh_data.cmd_buf[i] != ' ')
+    msh_exec.exec_depth--;
+}
+
+// 将参数重新拼接为命令行，包含空白或特殊字符的参数加引号，返回FALSE表示超长
+bool msh_join_args(char *buf, uint16_t size, int argc, char **argv)
+{
+    uint16_t len = 0;
+    int i;
+
+    // 单个参数原样使用，便于传入 "cmd1; cmd2" 形式的命令列表
+    if (argc == 1)
+    {
+        if (strlen(argv[0]) >= size)
         {
-            i++;
+            return FALSE;
         }
+        strcpy(buf, argv[0]);
+        return TRUE;
+    }
 
-        // 替换空格为结束符
-        if (i < msh_data.cmd_len)
+    for (i = 0; i < argc; i++)
+    {
+        const char *p = argv[i];
+        bool quote = (strpbrk(p, " \t;\"'\\") != NULL || *p == '\0') ? TRUE : FALSE;
+
+        if (i > 0 && len < size)
+        {
+            buf[len++] = ' ';
+        }
+        if (quote && len < size)
+        {
+            buf[len++] = '"';
+        }
+        for (; *p != '\0' && len < size; p++)
+        {
+            if ((*p == '"' || *p == '\\') && len < size)
+            {
+                buf[len++] = '\\';
+            }
+            if (len < size)
+            {
+                buf[len++] = *p;
+            }
+        }
+        if (quote && len < size)
         {
-            msh_data.cmd_buf[i++] = '\0';
+            buf[len++] = '"';
         }
     }
+    if (len >= size)
+    {
+        buf[size - 1] = '\0';
+        return FALSE;
+    }
+    buf[len] = '\0';
+    return TRUE;
+}
+
+// 获取当前命令第index个已解析参数
+const msh_arg_val_t *msh_arg_get(uint8_t index)
+{
+    if (index >= MSH_ARG_MAX_COUNT)
+    {
+        return NULL;
+    }
+    return &msh_exec.argval[index];
 }
 
 // 执行命令
 static void msh_execute_command(void)
 {
-    if (msh_data.cmd_len == 0)
+    if (msh_cur->cmd_len == 0)
     {
         return;
     }
 
     // 添加到历史记录
-    msh_add_history(msh_data.cmd_buf);
+    msh_add_history(msh_cur->cmd_buf);
+
+    // 解析并执行命令
+    msh_exec_line(msh_cur->cmd_buf);
+}
+
+// 获取命令数量
+uint8_t msh_cmd_count(void)
+{
+    return (uint8_t)(__msh_cmd_end - __msh_cmd_start);
+}
 
-    // 解析命令
-    msh_parse_command();
+// 按编号获取命令，编号即命令在命令表中的下标
+const msh_cmd_t *msh_cmd_get(uint8_t id)
+{
+    if (id >= msh_cmd_count())
+    {
+        return NULL;
+    }
+    return &__msh_cmd_start[id];
+}
 
-    // 查找并执行命令
+// 按名称查找命令
+const msh_cmd_t *msh_cmd_find(const char *name)
+{
     const msh_cmd_t *cmd;
-    int found = 0;
 
     for (cmd = __msh_cmd_start; cmd < __msh_cmd_end; cmd++)
     {
-        if (cmd->name && strcmp(msh_data.argv[0], cmd->name) == 0)
+        if (cmd->name && strcmp(name, cmd->name) == 0)
         {
-            cmd->func(msh_data.argc, msh_data.argv);
-            found = 1;
-            break;
+            return cmd;
         }
     }
+    return NULL;
+}
 
-    if (!found)
+// 检查参数并执行命令，argv[0]为命令名
+int8_t msh_cmd_invoke(const msh_cmd_t *cmd, int argc, char **argv, int *ret)
+{
+    if (cmd == NULL || cmd->func == NULL)
+    {
+        return MSH_EXEC_NOT_FOUND;
+    }
+    if (cmd->args != NULL &&
+        msh_arg_parse(cmd->args, cmd->args_num, argc - 1, &argv[1], msh_exec.argval) >= 0)
     {
-        printf("Command not found: %s\r\n", msh_data.argv[0]);
+        return MSH_EXEC_ARG_ERROR;
     }
+    *ret = cmd->func(argc, argv);
+    return MSH_EXEC_OK;
 }
 
 // 添加命令到历史记录
@@ -193,29 +499,29 @@ static void msh_add_history(const char *cmd)
     {
         return;
     }
-    if (msh_data.history_count > 0 &&
-        strcmp(cmd, msh_data.history[msh_data.history_count - 1]) == 0)
+    if (msh_cur->history_count > 0 &&
+        strcmp(cmd, msh_cur->history[msh_cur->history_count - 1]) == 0)
     {
         return;
     }
 
     // 如果历史记录已满，移除最旧的一条
-    if (msh_data.history_count >= MSH_HISTORY_MAX_COUNT)
+    if (msh_cur->history_count >= MSH_HISTORY_MAX_COUNT)
     {
         for (int i = 0; i < MSH_HISTORY_MAX_COUNT - 1; i++)
         {
-            strcpy(msh_data.history[i], msh_data.history[i + 1]);
+            strcpy(msh_cur->history[i], msh_cur->history[i + 1]);
         }
-        msh_data.history_count--;
+        msh_cur->history_count--;
     }
 
     // 添加新命令
-    strncpy(msh_data.history[msh_data.history_count], cmd, MSH_CMD_MAX_LENGTH - 1);
-    msh_data.history[msh_data.history_count][MSH_CMD_MAX_LENGTH - 1] = '\0';
-    msh_data.history_count++;
+    strncpy(msh_cur->history[msh_cur->history_count], cmd, MSH_CMD_MAX_LENGTH - 1);
+    msh_cur->history[msh_cur->history_count][MSH_CMD_MAX_LENGTH - 1] = '\0';
+    msh_cur->history_count++;
 
     // 重置历史索引
-    msh_data.history_index = -1;
+    msh_cur->history_index = -1;
 }
 
 // 处理特殊按键（退格、上下箭头、Tab）
@@ -224,13 +530,13 @@ static void msh_handle_special_key(uint8_t c)
     // 退格键 (ASCII 8)
     if (c == 8 || c == 127)
     { // 处理Backspace和Delete
-        if (msh_data.cmd_len > 0)
+        if (msh_cur->cmd_len > 0)
         {
-            msh_data.cmd_len--;
-            msh_data.cmd_buf[msh_data.cmd_len] = '\0';
+            msh_cur->cmd_len--;
+            msh_cur->cmd_buf[msh_cur->cmd_len] = '\0';
 
             // 发送退格序列：清除屏幕上的字符
-            printf("\b \b");
+            bsp_printf("\b \b");
         }
         return;
     }
@@ -248,57 +554,57 @@ static void msh_handle_special_key(uint8_t c)
                 // 上箭头
                 if (next2 == 'A')
                 {
-                    if (msh_data.history_count > 0)
+                    if (msh_cur->history_count > 0)
                     {
                         // 如果是第一次按上键，保存当前输入
-                        if (msh_data.history_index == -1)
+                        if (msh_cur->history_index == -1)
                         {
-                            msh_data.history_index = msh_data.history_count - 1;
+                            msh_cur->history_index = msh_cur->history_count - 1;
                         }
-                        else if (msh_data.history_index > 0)
+                        else if (msh_cur->history_index > 0)
                         {
-                            msh_data.history_index--;
+                            msh_cur->history_index--;
                         }
 
                         // 清除当前命令行
-                        while (msh_data.cmd_len > 0)
+                        while (msh_cur->cmd_len > 0)
                         {
-                            msh_data.cmd_len--;
-                            printf("\b \b");
+                            msh_cur->cmd_len--;
+                            bsp_printf("\b \b");
                         }
 
                         // 显示历史命令
-                        strcpy(msh_data.cmd_buf, msh_data.history[msh_data.history_index]);
-                        msh_data.cmd_len = strlen(msh_data.cmd_buf);
-                        printf("%s", msh_data.cmd_buf);
+                        strcpy(msh_cur->cmd_buf, msh_cur->history[msh_cur->history_index]);
+                        msh_cur->cmd_len = strlen(msh_cur->cmd_buf);
+                        bsp_printf("%s", msh_cur->cmd_buf);
                     }
                 }
                 // 下箭头
                 else if (next2 == 'B')
                 {
-                    if (msh_data.history_index != -1)
+                    if (msh_cur->history_index != -1)
                     {
-                        msh_data.history_index++;
+                        msh_cur->history_index++;
 
                         // 清除当前命令行
-                        while (msh_data.cmd_len > 0)
+                        while (msh_cur->cmd_len > 0)
                         {
-                            msh_data.cmd_len--;
-                            printf("\b \b");
+                            msh_cur->cmd_len--;
+                            bsp_printf("\b \b");
                         }
 
                         // 如果索引超出范围，显示空
-                        if (msh_data.history_index >= msh_data.history_count)
+                        if (msh_cur->history_index >= msh_cur->history_count)
                         {
-                            msh_data.cmd_len = 0;
-                            msh_data.history_index = -1;
+                            msh_cur->cmd_len = 0;
+                            msh_cur->history_index = -1;
                         }
                         else
                         {
                             // 显示历史命令
-                            strcpy(msh_data.cmd_buf, msh_data.history[msh_data.history_index]);
-                            msh_data.cmd_len = strlen(msh_data.cmd_buf);
-                            printf("%s", msh_data.cmd_buf);
+                            strcpy(msh_cur->cmd_buf, msh_cur->history[msh_cur->history_index]);
+                            msh_cur->cmd_len = strlen(msh_cur->cmd_buf);
+                            bsp_printf("%s", msh_cur->cmd_buf);
                         }
                     }
                 }
@@ -318,15 +624,20 @@ static void msh_handle_special_key(uint8_t c)
 // 命令补全功能
 static void msh_complete_command(void)
 {
-    if (msh_data.cmd_len == 0)
+    if (msh_cur->cmd_len == 0)
     {
         // 无输入时列出所有命令
 
-        printf("\r\n");
-        msh_cmd_help(0, NULL);
-        printf("\r\n");
+        const msh_cmd_t *cmd;
+
+        bsp_printf("\r\n");
+        for (cmd = __msh_cmd_start; cmd < __msh_cmd_end; cmd++)
+        {
+            bsp_printf("%s  ", cmd->name);
+        }
+        bsp_printf("\r\n");
         msh_print_prompt();
-        printf("%s", msh_data.cmd_buf);
+        bsp_printf("%s", msh_cur->cmd_buf);
         return;
     }
 
@@ -336,13 +647,13 @@ static void msh_complete_command(void)
     int match_count = 0;
     char partial[MSH_CMD_MAX_LENGTH];
 
-    strncpy(partial, msh_data.cmd_buf, msh_data.cmd_len);
-    partial[msh_data.cmd_len] = '\0';
+    strncpy(partial, msh_cur->cmd_buf, msh_cur->cmd_len);
+    partial[msh_cur->cmd_len] = '\0';
 
     // 统计匹配数量并记录第一个匹配项
     for (cmd = __msh_cmd_start; cmd < __msh_cmd_end; cmd++)
     {
-        if (cmd->name && strncmp(cmd->name, partial, msh_data.cmd_len) == 0)
+        if (cmd->name && strncmp(cmd->name, partial, msh_cur->cmd_len) == 0)
         {
             match_count++;
             if (match_cmd == NULL)
@@ -356,31 +667,31 @@ static void msh_complete_command(void)
     {
         // 唯一匹配项，补全命令
         const char *cmd_name = match_cmd->name;
-        int add_len = strlen(cmd_name) - msh_data.cmd_len;
+        int add_len = strlen(cmd_name) - msh_cur->cmd_len;
 
         // 添加补全的字符
-        strcpy(&msh_data.cmd_buf[msh_data.cmd_len], &cmd_name[msh_data.cmd_len]);
-        msh_data.cmd_len += add_len;
+        strcpy(&msh_cur->cmd_buf[msh_cur->cmd_len], &cmd_name[msh_cur->cmd_len]);
+        msh_cur->cmd_len += add_len;
 
         // 输出补全的部分并添加空格
-        printf("%s ", &cmd_name[msh_data.cmd_len - add_len]);
-        msh_data.cmd_len++; // 算上添加的空格
-        msh_data.cmd_buf[msh_data.cmd_len - 1] = ' ';
+        bsp_printf("%s ", &cmd_name[msh_cur->cmd_len - add_len]);
+        msh_cur->cmd_len++; // 算上添加的空格
+        msh_cur->cmd_buf[msh_cur->cmd_len - 1] = ' ';
     }
     else if (match_count > 1)
     {
         // 多个匹配项，显示所有匹配命令
-        printf("\r\n");
+        bsp_printf("\r\n");
         for (cmd = __msh_cmd_start; cmd < __msh_cmd_end; cmd++)
         {
-            if (cmd->name && strncmp(cmd->name, partial, msh_data.cmd_len) == 0)
+            if (cmd->name && strncmp(cmd->name, partial, msh_cur->cmd_len) == 0)
             {
-                printf("%s  ", cmd->name);
+                bsp_printf("%s  ", cmd->name);
             }
         }
-        printf("\r\n");
+        bsp_printf("\r\n");
         msh_print_prompt();
-        printf("%s", msh_data.cmd_buf);
+        bsp_printf("%s", msh_cur->cmd_buf);
     }
 }
 
@@ -393,20 +704,24 @@ static void msh_handle_char(uint8_t c)
         // 回车换行
         if (c == '\r' || c == '\n')
         {
-            if (msh_data.cmd_len > 0)
+            if (msh_cur->cmd_len > 0)
             {
-                printf("\r\n");
+                bsp_printf("\r\n");
                 msh_execute_command();
 
                 // 重置命令缓冲区
-                msh_data.cmd_len = 0;
-                memset(msh_data.cmd_buf, 0, MSH_CMD_MAX_LENGTH);
+                msh_cur->cmd_len = 0;
+                memset(msh_cur->cmd_buf, 0, MSH_CMD_MAX_LENGTH);
             }
             else
             {
-                printf("\r\n");
+                bsp_printf("\r\n");
+            }
+            // 切换到RPC模式后不再输出提示符，流式输出结束后再输出提示符
+            if (!msh_rpc_active() && !msh_stream_active())
+            {
+                msh_print_prompt();
             }
-            msh_print_prompt();
         }
         else
         {
@@ -417,34 +732,57 @@ static void msh_handle_char(uint8_t c)
     else
     {
         // 普通字符，添加到命令缓冲区
-        if (msh_data.cmd_len < MSH_CMD_MAX_LENGTH - 1)
+        if (msh_cur->cmd_len < MSH_CMD_MAX_LENGTH - 1)
         {
-            msh_data.cmd_buf[msh_data.cmd_len++] = c;
-            msh_data.cmd_buf[msh_data.cmd_len] = '\0';
-            uart_send_byte(c); // 回显字符
+            msh_cur->cmd_buf[msh_cur->cmd_len++] = c;
+            msh_cur->cmd_buf[msh_cur->cmd_len] = '\0';
+            uart_stdout_write(&c, 1); // 回显字符
         }
     }
 }
 
-// MSH终端主处理函数
-void msh_process(void)
+// 处理一个会话接收缓冲区中的所有字符
+static void msh_session_process(void)
 {
-    // 处理接收缓冲区中的所有字符
     while (msh_get_recv_count() > 0)
     {
         uint8_t c = msh_read_char();
+        if (msh_rpc_active())
+        {
+            msh_rpc_input(c);
+            // 退出RPC模式后恢复提示符
+            if (!msh_rpc_active())
+            {
+                msh_print_prompt();
+            }
+            continue;
+        }
+        // 流式输出期间只处理取消和翻页按键
+        if (msh_stream_active())
+        {
+            msh_stream_input(c);
+            continue;
+        }
         msh_handle_char(c);
     }
 }
 
-// MSH接收中断回调函数（由硬件驱动调用）
-void msh_rx_input(uint8_t data)
+// MSH终端主处理函数
+void msh_process(void)
 {
-    // 将接收到的数据放入缓冲区
-    uint16_t next_head = (msh_data.recv_head + 1) % MSH_UART_BUFFER_SIZE;
-    if (next_head != msh_data.recv_tail)
-    { // 缓冲区未满
-        msh_data.recv_buf[msh_data.recv_head] = data;
-        msh_data.recv_head = next_head;
+    uint8_t i;
+
+    for (i = 0; i < MSH_SESSION_NUM; i++)
+    {
+        msh_session_t *session = &msh_sessions[i];
+        msh_session_t *prev;
+
+        if (!session->enabled)
+        {
+            continue;
+        }
+        prev = msh_session_switch(session);
+        msh_session_process();
+        msh_session_switch(prev);
     }
 }
@@ -2,17 +2,30 @@
 #define __MSH_H__
 
 #include "bsp_sys_pub.h"
+#include "msh_arg.h"
 // 配置参数
 #define MSH_CMD_MAX_LENGTH     64    // 命令最大长度
 #define MSH_ARG_MAX_COUNT      8     // 最大参数数量
 #define MSH_HISTORY_MAX_COUNT  5     // 历史命令最大数量
-#define MSH_UART_BUFFER_SIZE   128   // UART缓冲区大小
+#define MSH_RX_CHUNK_SIZE      16    // 每次从串口驱动批量读取的字节数
+#define MSH_SESSION_NUM        1     // 会话数量，每个会话占用约 MSH_CMD_MAX_LENGTH*(MSH_HISTORY_MAX_COUNT+1)+MSH_RX_CHUNK_SIZE 字节
+#define MSH_EXEC_DEPTH_MAX     2     // 命令嵌套执行最大深度
+#define MSH_UART3_BAUDRATE     115200 // MSH_SESSION_NUM大于1时会话1使用UART3
+#define MSH_PRINTF_BENCH       0     // fmtbench命令（对比工具链sprintf，会链接工具链的格式化库）
  typedef int (*mshfunc)(int argc, char **argv);
+// 会话输出函数
+typedef void (*msh_write_t)(const uint8_t *data, uint16_t len);
+// 会话输入函数，读取最多len字节，返回实际读取的字节数
+typedef uint8_t (*msh_read_t)(uint8_t *buf, uint8_t len);
+// 会话（定义在msh.c中）
+typedef struct msh_session msh_session_t;
 // 命令结构体
 typedef struct {
     const char *name;            // 命令名称
     const char *desc;            // 命令描述
     mshfunc func;  // 命令处理函数
+    const msh_arg_spec_t *args; // 参数声明（可选，为NULL时不检查参数）
+    uint8_t args_num;           // 参数声明数量
 } msh_cmd_t;
 
 // 命令注册宏
@@ -24,23 +37,57 @@ typedef struct {
     { \
         #name, desc, (mshfunc)func \
     }
+// 带参数声明的命令，执行前按声明解析参数，处理函数通过msh_arg_get()获取结果
+#define MSH_CMD_DEF_ARGS(name, desc, func, args) \
+    { \
+        #name, desc, (mshfunc)func, args, sizeof(args) / sizeof(args[0]) \
+    }
 
 //内置命令
 int msh_cmd_echo(int argc, char **argv);
 int msh_cmd_help(int argc, char **argv);
 int msh_cmd_clear(int argc, char **argv);
 
-// MSH终端初始化
+// 命令执行结果
+#define MSH_EXEC_OK         0   // 已执行
+#define MSH_EXEC_NOT_FOUND  1   // 命令不存在
+#define MSH_EXEC_ARG_ERROR  2   // 参数检查失败
+
+// 命令表访问
+uint8_t msh_cmd_count(void);
+const msh_cmd_t *msh_cmd_get(uint8_t id);
+const msh_cmd_t *msh_cmd_find(const char *name);
+// 检查参数并执行命令，argv[0]为命令名，返回MSH_EXEC_xxx
+int8_t msh_cmd_invoke(const msh_cmd_t *cmd, int argc, char **argv, int *ret);
+
+// 执行一行命令，多条命令以';'分隔，line会被原地修改
+void msh_exec_line(char *line);
+// 将参数重新拼接为可再次解析的命令行，返回FALSE表示超长
+bool msh_join_args(char *buf, uint16_t size, int argc, char **argv);
+
+// 获取当前命令第index个已解析参数（从0开始，不含命令名）
+const msh_arg_val_t *msh_arg_get(uint8_t index);
+
+// MSH终端初始化，启动会话0
 void msh_init(void);
 
+// 启动会话，write为NULL时使用默认标准输出，read为NULL时从控制台串口读取
+void msh_session_init(uint8_t id, msh_write_t write, msh_read_t read);
+void msh_banner(uint8_t id);
+msh_session_t *msh_session_get(uint8_t id);
+msh_session_t *msh_session_current(void);
+// 切换当前会话（标准输出同时切换），返回之前的会话
+msh_session_t *msh_session_switch(msh_session_t *session);
+
+// 打印命令提示符
+void msh_prompt(void);
+
 // MSH终端主处理函数（主循环中调用）
 void msh_process(void);
-// MSH接收中断回调函数（由硬件驱动调用）
-void msh_rx_input(uint8_t data);
 // 发送字符串助手函数
 void uart_send_bytes(const uint8_t *data, uint16_t len);
 static inline void msh_print(const char *str) {
-    uart_send_bytes((const uint8_t*)str, strlen(str));
+    uart_stdout_write((const uint8_t*)str, strlen(str));
 }
 void msh_task_init(void);
 #endif // MSH_H
@@ -0,0 +1,324 @@
+#include "msh_arg.h"
+
+// 单个十六进制字符转数值，非法字符返回-1
+static int8_t msh_arg_hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    c |= 0x20; // 转小写
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// 解析无符号数字串，base为10或16，溢出或非法字符返回FALSE
+static bool msh_arg_to_uint(const char *str, uint8_t base, uint32_t *out)
+{
+    uint32_t value = 0;
+    uint32_t limit = 0xFFFFFFFFUL / base;
+
+    if (*str == '\0')
+    {
+        return FALSE;
+    }
+    while (*str)
+    {
+        int8_t d = msh_arg_hex_digit(*str++);
+        if (d < 0 || d >= base || value > limit)
+        {
+            return FALSE;
+        }
+        value *= base;
+        if (value > 0xFFFFFFFFUL - (uint8_t)d)
+        {
+            return FALSE;
+        }
+        value += (uint8_t)d;
+    }
+    *out = value;
+    return TRUE;
+}
+
+// 字符串转有符号整数（十进制或0x前缀十六进制）
+bool msh_arg_to_int(const char *str, int32_t *out)
+{
+    uint32_t value;
+    bool neg = FALSE;
+
+    if (*str == '-' || *str == '+')
+    {
+        neg = (*str == '-') ? TRUE : FALSE;
+        str++;
+    }
+    if (str[0] == '0' && (str[1] | 0x20) == 'x')
+    {
+        if (!msh_arg_to_uint(str + 2, 16, &value))
+        {
+            return FALSE;
+        }
+    }
+    else if (!msh_arg_to_uint(str, 10, &value))
+    {
+        return FALSE;
+    }
+
+    if (neg)
+    {
+        if (value > 0x80000000UL)
+        {
+            return FALSE;
+        }
+        *out = (int32_t)(0 - value);
+    }
+    else
+    {
+        if (value > 0x7FFFFFFFUL)
+        {
+            return FALSE;
+        }
+        *out = (int32_t)value;
+    }
+    return TRUE;
+}
+
+// 字符串转十六进制整数，允许省略0x前缀，结果按32位原样保存
+bool msh_arg_to_hex(const char *str, int32_t *out)
+{
+    uint32_t value;
+
+    if (str[0] == '0' && (str[1] | 0x20) == 'x')
+    {
+        str += 2;
+    }
+    if (!msh_arg_to_uint(str, 16, &value))
+    {
+        return FALSE;
+    }
+    *out = (int32_t)value;
+    return TRUE;
+}
+
+// 字符串转定点数，如decimals=2时 "-1.5" -> -150，多余的小数位截断
+bool msh_arg_to_fixed(const char *str, uint8_t decimals, int32_t *out)
+{
+    char buf[12];
+    uint8_t len = 0;
+    uint8_t frac = 0;
+    bool dot = FALSE;
+
+    if (*str == '-' || *str == '+')
+    {
+        buf[len++] = *str++;
+    }
+    // 去掉小数点，拼接出放大后的整数串
+    for (; *str; str++)
+    {
+        if (*str == '.' && !dot)
+        {
+            dot = TRUE;
+            continue;
+        }
+        if (*str < '0' || *str > '9')
+        {
+            return FALSE;
+        }
+        if (dot && frac >= decimals)
+        {
+            continue;
+        }
+        if (len >= sizeof(buf) - 1)
+        {
+            return FALSE;
+        }
+        buf[len++] = *str;
+        if (dot)
+        {
+            frac++;
+        }
+    }
+    // 补齐小数位
+    while (frac < decimals)
+    {
+        if (len >= sizeof(buf) - 1)
+        {
+            return FALSE;
+        }
+        buf[len++] = '0';
+        frac++;
+    }
+    buf[len] = '\0';
+
+    return msh_arg_to_int(buf, out);
+}
+
+// 字符串匹配枚举列表，结果为列表下标
+bool msh_arg_to_enum(const char *str, const char *const *list, int32_t *out)
+{
+    int32_t i;
+
+    if (list == NULL)
+    {
+        return FALSE;
+    }
+    for (i = 0; list[i] != NULL; i++)
+    {
+        if (strcmp(str, list[i]) == 0)
+        {
+            *out = i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// 十六进制字符串原地解码为字节数组，允许用':'、'-'、空格分隔字节
+bool msh_arg_to_bytes(char *str, uint8_t **data, uint8_t *len)
+{
+    uint8_t *dst = (uint8_t *)str;
+    uint8_t count = 0;
+
+    if (str[0] == '0' && (str[1] | 0x20) == 'x')
+    {
+        str += 2;
+    }
+    while (*str)
+    {
+        int8_t hi, lo;
+
+        if (*str == ':' || *str == '-' || *str == ' ')
+        {
+            str++;
+            continue;
+        }
+        hi = msh_arg_hex_digit(str[0]);
+        lo = (hi >= 0) ? msh_arg_hex_digit(str[1]) : -1;
+        if (lo < 0 || count == 0xFF)
+        {
+            return FALSE;
+        }
+        // 写指针始终落后于读指针，可以原地解码
+        dst[count++] = (uint8_t)((hi << 4) | lo);
+        str += 2;
+    }
+    *data = dst;
+    *len = count;
+    return TRUE;
+}
+
+// 按声明解析单个参数
+static bool msh_arg_parse_one(const msh_arg_spec_t *spec, char *str, msh_arg_val_t *val)
+{
+    bool ok;
+    size_t len;
+
+    switch (spec->type)
+    {
+    case MSH_ARG_INT:
+        ok = msh_arg_to_int(str, &val->i);
+        break;
+    case MSH_ARG_HEX:
+        ok = msh_arg_to_hex(str, &val->i);
+        break;
+    case MSH_ARG_FIXED:
+        ok = msh_arg_to_fixed(str, spec->decimals, &val->i);
+        break;
+    case MSH_ARG_ENUM:
+        return msh_arg_to_enum(str, spec->enum_list, &val->i);
+    case MSH_ARG_BYTES:
+        if (!msh_arg_to_bytes(str, &val->bytes.data, &val->bytes.len))
+        {
+            return FALSE;
+        }
+        return (val->bytes.len >= spec->min && val->bytes.len <= spec->max) ? TRUE : FALSE;
+    case MSH_ARG_STR:
+        len = strlen(str);
+        val->s = str;
+        return (len >= (size_t)spec->min && len <= (size_t)spec->max) ? TRUE : FALSE;
+    default:
+        return FALSE;
+    }
+
+    if (!ok)
+    {
+        return FALSE;
+    }
+    // 十六进制参数按无符号比较范围
+    if (spec->type == MSH_ARG_HEX)
+    {
+        return ((uint32_t)val->i >= (uint32_t)spec->min &&
+                (uint32_t)val->i <= (uint32_t)spec->max) ? TRUE : FALSE;
+    }
+    return (val->i >= spec->min && val->i <= spec->max) ? TRUE : FALSE;
+}
+
+// 按参数声明解析并检查参数
+int8_t msh_arg_parse(const msh_arg_spec_t *spec, uint8_t spec_num,
+                     int argc, char **argv, msh_arg_val_t *vals)
+{
+    uint8_t i;
+
+    if (argc > spec_num)
+    {
+        return (int8_t)spec_num; // 参数过多
+    }
+    for (i = 0; i < spec_num; i++)
+    {
+        if (i >= argc)
+        {
+            if (!spec[i].optional)
+            {
+                return (int8_t)i; // 缺少必需参数
+            }
+            memset(&vals[i], 0, sizeof(vals[i]));
+            continue;
+        }
+        if (!msh_arg_parse_one(&spec[i], argv[i], &vals[i]))
+        {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+// 打印参数用法
+void msh_arg_print_usage(const char *cmd_name, const msh_arg_spec_t *spec, uint8_t spec_num)
+{
+    uint8_t i;
+
+    bsp_printf("Usage: %s", cmd_name);
+    for (i = 0; i < spec_num; i++)
+    {
+        bsp_printf(spec[i].optional ? " [%s]" : " <%s>", spec[i].name);
+    }
+    bsp_printf("\r\n");
+    for (i = 0; i < spec_num; i++)
+    {
+        const char *const *e;
+
+        switch (spec[i].type)
+        {
+        case MSH_ARG_ENUM:
+            bsp_printf("  %s:", spec[i].name);
+            for (e = spec[i].enum_list; e != NULL && *e != NULL; e++)
+            {
+                bsp_printf(" %s", *e);
+            }
+            bsp_printf("\r\n");
+            break;
+        case MSH_ARG_HEX:
+            bsp_printf("  %s: 0x%lx..0x%lx\r\n", spec[i].name, spec[i].min, spec[i].max);
+            break;
+        case MSH_ARG_BYTES:
+        case MSH_ARG_STR:
+            bsp_printf("  %s: len %ld..%ld\r\n", spec[i].name, spec[i].min, spec[i].max);
+            break;
+        default:
+            bsp_printf("  %s: %ld..%ld\r\n", spec[i].name, spec[i].min, spec[i].max);
+            break;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef __MSH_ARG_H__
+#define __MSH_ARG_H__
+
+#include "bsp_sys_pub.h"
+
+// 参数类型
+typedef enum
+{
+    MSH_ARG_INT = 0, // 有符号整数，支持十进制和0x前缀十六进制
+    MSH_ARG_HEX,     // 十六进制整数，0x前缀可省略
+    MSH_ARG_FIXED,   // 定点小数，结果为放大10^decimals倍的整数
+    MSH_ARG_ENUM,    // 枚举字符串，结果为在列表中的下标
+    MSH_ARG_BYTES,   // 十六进制字节数组，如 "01ab02" 或 "01:ab:02"
+    MSH_ARG_STR,     // 原始字符串
+} msh_arg_type_t;
+
+// 参数声明
+typedef struct
+{
+    const char *name;              // 参数名称（用于打印用法）
+    msh_arg_type_t type;           // 参数类型
+    uint8_t optional;              // 是否可省略
+    uint8_t decimals;              // MSH_ARG_FIXED的小数位数
+    int32_t min;                   // 数值下限（FIXED为放大后的值）；BYTES/STR为最小长度
+    int32_t max;                   // 数值上限；BYTES/STR为最大长度
+    const char *const *enum_list;  // MSH_ARG_ENUM的候选列表，以NULL结尾
+} msh_arg_spec_t;
+
+// 解析后的参数值
+typedef union
+{
+    int32_t i;       // INT/HEX/FIXED/ENUM
+    const char *s;   // STR
+    struct
+    {
+        uint8_t *data;
+        uint8_t len;
+    } bytes;         // BYTES（原地解码，指向命令缓冲区）
+} msh_arg_val_t;
+
+// 参数声明辅助宏，OPT版本表示该参数可省略（可省略参数需放在最后）
+#define MSH_ARG_SPEC(name, type, opt, dec, min, max, list) \
+    { #name, type, opt, dec, min, max, list }
+#define MSH_ARG_DEF_INT(name, min, max)             MSH_ARG_SPEC(name, MSH_ARG_INT, 0, 0, min, max, NULL)
+#define MSH_ARG_OPT_INT(name, min, max)             MSH_ARG_SPEC(name, MSH_ARG_INT, 1, 0, min, max, NULL)
+#define MSH_ARG_DEF_HEX(name, min, max)             MSH_ARG_SPEC(name, MSH_ARG_HEX, 0, 0, min, max, NULL)
+#define MSH_ARG_OPT_HEX(name, min, max)             MSH_ARG_SPEC(name, MSH_ARG_HEX, 1, 0, min, max, NULL)
+#define MSH_ARG_DEF_FIXED(name, decimals, min, max) MSH_ARG_SPEC(name, MSH_ARG_FIXED, 0, decimals, min, max, NULL)
+#define MSH_ARG_OPT_FIXED(name, decimals, min, max) MSH_ARG_SPEC(name, MSH_ARG_FIXED, 1, decimals, min, max, NULL)
+#define MSH_ARG_DEF_ENUM(name, list)                MSH_ARG_SPEC(name, MSH_ARG_ENUM, 0, 0, 0, 0, list)
+#define MSH_ARG_OPT_ENUM(name, list)                MSH_ARG_SPEC(name, MSH_ARG_ENUM, 1, 0, 0, 0, list)
+#define MSH_ARG_DEF_BYTES(name, min_len, max_len)   MSH_ARG_SPEC(name, MSH_ARG_BYTES, 0, 0, min_len, max_len, NULL)
+#define MSH_ARG_OPT_BYTES(name, min_len, max_len)   MSH_ARG_SPEC(name, MSH_ARG_BYTES, 1, 0, min_len, max_len, NULL)
+#define MSH_ARG_DEF_STR(name, min_len, max_len)     MSH_ARG_SPEC(name, MSH_ARG_STR, 0, 0, min_len, max_len, NULL)
+#define MSH_ARG_OPT_STR(name, min_len, max_len)     MSH_ARG_SPEC(name, MSH_ARG_STR, 1, 0, min_len, max_len, NULL)
+
+// 字符串转换函数，成功返回TRUE
+bool msh_arg_to_int(const char *str, int32_t *out);
+bool msh_arg_to_hex(const char *str, int32_t *out);
+bool msh_arg_to_fixed(const char *str, uint8_t decimals, int32_t *out);
+bool msh_arg_to_enum(const char *str, const char *const *list, int32_t *out);
+bool msh_arg_to_bytes(char *str, uint8_t **data, uint8_t *len);
+
+/**
+ * @brief 按参数声明解析并检查参数
+ * @param spec 参数声明表
+ * @param spec_num 参数声明数量
+ * @param argc 参数数量（不含命令名）
+ * @param argv 参数列表（不含命令名）
+ * @param vals 解析结果，至少spec_num个元素
+ * @return 成功返回-1，否则返回出错参数的下标
+ */
+int8_t msh_arg_parse(const msh_arg_spec_t *spec, uint8_t spec_num,
+                     int argc, char **argv, msh_arg_val_t *vals);
+
+// 打印参数用法
+void msh_arg_print_usage(const char *cmd_name, const msh_arg_spec_t *spec, uint8_t spec_num);
+
+#endif
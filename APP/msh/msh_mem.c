@@ -0,0 +1,515 @@
+#include "msh_mem.h"
+#include "msh_stream.h"
+#include <stddef.h>
+
+// 寄存器标志
+#define MSH_MEM_REG_NOREAD      0x01  // 读取有副作用，不读取
+
+// 位域：单个位置1时显示名称，多位字段显示 名称=值
+typedef struct
+{
+    const char *name;
+    uint8_t mask;
+} msh_mem_field_t;
+
+// 寄存器
+typedef struct
+{
+    const char *name;
+    uint8_t offset;                 // 相对外设基址的偏移
+    uint8_t flags;
+    const msh_mem_field_t *fields;  // 位域表，NULL表示只显示数值
+    uint8_t field_num;
+} msh_mem_reg_t;
+
+// 外设
+typedef struct
+{
+    const char *name;
+    uint16_t base;
+    const msh_mem_reg_t *regs;
+    uint8_t reg_num;
+} msh_mem_periph_t;
+
+#define MSH_MEM_ARRAY_NUM(a)             (uint8_t)(sizeof(a) / sizeof((a)[0]))
+#define MSH_MEM_FIELD(periph, reg, bit)  {#bit, periph##_##reg##_##bit}
+#define MSH_MEM_REG(type, reg, fields)   {#reg, offsetof(type, reg), 0, fields, MSH_MEM_ARRAY_NUM(fields)}
+#define MSH_MEM_REG_RAW(type, reg)       {#reg, offsetof(type, reg), 0, NULL, 0}
+#define MSH_MEM_REG_WO(type, reg)        {#reg, offsetof(type, reg), MSH_MEM_REG_NOREAD, NULL, 0}
+#define MSH_MEM_PERIPH(name, base, regs) {name, base, regs, MSH_MEM_ARRAY_NUM(regs)}
+
+static const char msh_mem_hex_digits[] = "0123456789ABCDEF";
+
+/////////////////////////////寄存器表/////////////////////////////
+
+static const msh_mem_field_t msh_mem_clk_ickr[] = {
+    MSH_MEM_FIELD(CLK, ICKR, SWUAH), MSH_MEM_FIELD(CLK, ICKR, LSIRDY), MSH_MEM_FIELD(CLK, ICKR, LSIEN),
+    MSH_MEM_FIELD(CLK, ICKR, FHWU), MSH_MEM_FIELD(CLK, ICKR, HSIRDY), MSH_MEM_FIELD(CLK, ICKR, HSIEN),
+};
+static const msh_mem_field_t msh_mem_clk_eckr[] = {
+    MSH_MEM_FIELD(CLK, ECKR, HSERDY), MSH_MEM_FIELD(CLK, ECKR, HSEEN),
+};
+static const msh_mem_field_t msh_mem_clk_swcr[] = {
+    MSH_MEM_FIELD(CLK, SWCR, SWIF), MSH_MEM_FIELD(CLK, SWCR, SWIEN),
+    MSH_MEM_FIELD(CLK, SWCR, SWEN), MSH_MEM_FIELD(CLK, SWCR, SWBSY),
+};
+static const msh_mem_field_t msh_mem_clk_ckdivr[] = {
+    MSH_MEM_FIELD(CLK, CKDIVR, HSIDIV), MSH_MEM_FIELD(CLK, CKDIVR, CPUDIV),
+};
+static const msh_mem_field_t msh_mem_clk_pckenr1[] = {
+    MSH_MEM_FIELD(CLK, PCKENR1, TIM1), MSH_MEM_FIELD(CLK, PCKENR1, TIM3), MSH_MEM_FIELD(CLK, PCKENR1, TIM2),
+    MSH_MEM_FIELD(CLK, PCKENR1, TIM4), MSH_MEM_FIELD(CLK, PCKENR1, UART3), MSH_MEM_FIELD(CLK, PCKENR1, UART1),
+    MSH_MEM_FIELD(CLK, PCKENR1, SPI), MSH_MEM_FIELD(CLK, PCKENR1, I2C),
+};
+static const msh_mem_field_t msh_mem_clk_pckenr2[] = {
+    MSH_MEM_FIELD(CLK, PCKENR2, CAN), MSH_MEM_FIELD(CLK, PCKENR2, ADC), MSH_MEM_FIELD(CLK, PCKENR2, AWU),
+};
+static const msh_mem_field_t msh_mem_clk_cssr[] = {
+    MSH_MEM_FIELD(CLK, CSSR, CSSD), MSH_MEM_FIELD(CLK, CSSR, CSSDIE),
+    MSH_MEM_FIELD(CLK, CSSR, AUX), MSH_MEM_FIELD(CLK, CSSR, CSSEN),
+};
+static const msh_mem_field_t msh_mem_clk_ccor[] = {
+    MSH_MEM_FIELD(CLK, CCOR, CCOBSY), MSH_MEM_FIELD(CLK, CCOR, CCORDY),
+    MSH_MEM_FIELD(CLK, CCOR, CCOSEL), MSH_MEM_FIELD(CLK, CCOR, CCOEN),
+};
+static const msh_mem_reg_t msh_mem_clk_regs[] = {
+    MSH_MEM_REG(CLK_TypeDef, ICKR, msh_mem_clk_ickr),
+    MSH_MEM_REG(CLK_TypeDef, ECKR, msh_mem_clk_eckr),
+    MSH_MEM_REG_RAW(CLK_TypeDef, CMSR),
+    MSH_MEM_REG_RAW(CLK_TypeDef, SWR),
+    MSH_MEM_REG(CLK_TypeDef, SWCR, msh_mem_clk_swcr),
+    MSH_MEM_REG(CLK_TypeDef, CKDIVR, msh_mem_clk_ckdivr),
+    MSH_MEM_REG(CLK_TypeDef, PCKENR1, msh_mem_clk_pckenr1),
+    MSH_MEM_REG(CLK_TypeDef, CSSR, msh_mem_clk_cssr),
+    MSH_MEM_REG(CLK_TypeDef, CCOR, msh_mem_clk_ccor),
+    MSH_MEM_REG(CLK_TypeDef, PCKENR2, msh_mem_clk_pckenr2),
+    MSH_MEM_REG_RAW(CLK_TypeDef, HSITRIMR),
+    MSH_MEM_REG_RAW(CLK_TypeDef, SWIMCCR),
+};
+
+static const msh_mem_reg_t msh_mem_gpio_regs[] = {
+    MSH_MEM_REG_RAW(GPIO_TypeDef, ODR),
+    MSH_MEM_REG_RAW(GPIO_TypeDef, IDR),
+    MSH_MEM_REG_RAW(GPIO_TypeDef, DDR),
+    MSH_MEM_REG_RAW(GPIO_TypeDef, CR1),
+    MSH_MEM_REG_RAW(GPIO_TypeDef, CR2),
+};
+
+static const msh_mem_field_t msh_mem_flash_cr1[] = {
+    MSH_MEM_FIELD(FLASH, CR1, HALT), MSH_MEM_FIELD(FLASH, CR1, AHALT),
+    MSH_MEM_FIELD(FLASH, CR1, IE), MSH_MEM_FIELD(FLASH, CR1, FIX),
+};
+static const msh_mem_field_t msh_mem_flash_cr2[] = {
+    MSH_MEM_FIELD(FLASH, CR2, OPT), MSH_MEM_FIELD(FLASH, CR2, WPRG), MSH_MEM_FIELD(FLASH, CR2, ERASE),
+    MSH_MEM_FIELD(FLASH, CR2, FPRG), MSH_MEM_FIELD(FLASH, CR2, PRG),
+};
+static const msh_mem_field_t msh_mem_flash_iapsr[] = {
+    MSH_MEM_FIELD(FLASH, IAPSR, HVOFF), MSH_MEM_FIELD(FLASH, IAPSR, DUL),
+    MSH_MEM_FIELD(FLASH, IAPSR, EOP), MSH_MEM_FIELD(FLASH, IAPSR, PUL),
+};
+static const msh_mem_reg_t msh_mem_flash_regs[] = {
+    MSH_MEM_REG(FLASH_TypeDef, CR1, msh_mem_flash_cr1),
+    MSH_MEM_REG(FLASH_TypeDef, CR2, msh_mem_flash_cr2),
+    MSH_MEM_REG_RAW(FLASH_TypeDef, NCR2),
+    MSH_MEM_REG_RAW(FLASH_TypeDef, FPR),
+    MSH_MEM_REG_RAW(FLASH_TypeDef, NFPR),
+    MSH_MEM_REG(FLASH_TypeDef, IAPSR, msh_mem_flash_iapsr),
+};
+
+// UART1和UART3的SR/CR1/CR2位定义相同
+static const msh_mem_field_t msh_mem_uart_sr[] = {
+    MSH_MEM_FIELD(UART1, SR, TXE), MSH_MEM_FIELD(UART1, SR, TC), MSH_MEM_FIELD(UART1, SR, RXNE),
+    MSH_MEM_FIELD(UART1, SR, IDLE), MSH_MEM_FIELD(UART1, SR, OR), MSH_MEM_FIELD(UART1, SR, NF),
+    MSH_MEM_FIELD(UART1, SR, FE), MSH_MEM_FIELD(UART1, SR, PE),
+};
+static const msh_mem_field_t msh_mem_uart_cr1[] = {
+    MSH_MEM_FIELD(UART1, CR1, R8), MSH_MEM_FIELD(UART1, CR1, T8), MSH_MEM_FIELD(UART1, CR1, UARTD),
+    MSH_MEM_FIELD(UART1, CR1, M), MSH_MEM_FIELD(UART1, CR1, WAKE), MSH_MEM_FIELD(UART1, CR1, PCEN),
+    MSH_MEM_FIELD(UART1, CR1, PS), MSH_MEM_FIELD(UART1, CR1, PIEN),
+};
+static const msh_mem_field_t msh_mem_uart_cr2[] = {
+    MSH_MEM_FIELD(UART1, CR2, TIEN), MSH_MEM_FIELD(UART1, CR2, TCIEN), MSH_MEM_FIELD(UART1, CR2, RIEN),
+    MSH_MEM_FIELD(UART1, CR2, ILIEN), MSH_MEM_FIELD(UART1, CR2, TEN), MSH_MEM_FIELD(UART1, CR2, REN),
+    MSH_MEM_FIELD(UART1, CR2, RWU), MSH_MEM_FIELD(UART1, CR2, SBK),
+};
+static const msh_mem_field_t msh_mem_uart1_cr3[] = {
+    MSH_MEM_FIELD(UART1, CR3, LINEN), MSH_MEM_FIELD(UART1, CR3, STOP), MSH_MEM_FIELD(UART1, CR3, CKEN),
+    MSH_MEM_FIELD(UART1, CR3, CPOL), MSH_MEM_FIELD(UART1, CR3, CPHA), MSH_MEM_FIELD(UART1, CR3, LBCL),
+};
+static const msh_mem_field_t msh_mem_uart1_cr5[] = {
+    MSH_MEM_FIELD(UART1, CR5, SCEN), MSH_MEM_FIELD(UART1, CR5, NACK), MSH_MEM_FIELD(UART1, CR5, HDSEL),
+    MSH_MEM_FIELD(UART1, CR5, IRLP), MSH_MEM_FIELD(UART1, CR5, IREN),
+};
+static const msh_mem_reg_t msh_mem_uart1_regs[] = {
+    MSH_MEM_REG(UART1_TypeDef, SR, msh_mem_uart_sr),
+    MSH_MEM_REG_WO(UART1_TypeDef, DR), // 读DR会清除RXNE并丢失接收数据
+    MSH_MEM_REG_RAW(UART1_TypeDef, BRR1),
+    MSH_MEM_REG_RAW(UART1_TypeDef, BRR2),
+    MSH_MEM_REG(UART1_TypeDef, CR1, msh_mem_uart_cr1),
+    MSH_MEM_REG(UART1_TypeDef, CR2, msh_mem_uart_cr2),
+    MSH_MEM_REG(UART1_TypeDef, CR3, msh_mem_uart1_cr3),
+    MSH_MEM_REG_RAW(UART1_TypeDef, CR4),
+    MSH_MEM_REG(UART1_TypeDef, CR5, msh_mem_uart1_cr5),
+};
+
+static const msh_mem_field_t msh_mem_uart3_cr3[] = {
+    MSH_MEM_FIELD(UART3, CR3, LINEN), MSH_MEM_FIELD(UART3, CR3, STOP),
+};
+static const msh_mem_field_t msh_mem_uart3_cr6[] = {
+    MSH_MEM_FIELD(UART3, CR6, LDUM), MSH_MEM_FIELD(UART3, CR6, LSLV), MSH_MEM_FIELD(UART3, CR6, LASE),
+    MSH_MEM_FIELD(UART3, CR6, LHDIEN), MSH_MEM_FIELD(UART3, CR6, LHDF), MSH_MEM_FIELD(UART3, CR6, LSF),
+};
+static const msh_mem_reg_t msh_mem_uart3_regs[] = {
+    MSH_MEM_REG(UART3_TypeDef, SR, msh_mem_uart_sr),
+    MSH_MEM_REG_WO(UART3_TypeDef, DR),
+    MSH_MEM_REG_RAW(UART3_TypeDef, BRR1),
+    MSH_MEM_REG_RAW(UART3_TypeDef, BRR2),
+    MSH_MEM_REG(UART3_TypeDef, CR1, msh_mem_uart_cr1),
+    MSH_MEM_REG(UART3_TypeDef, CR2, msh_mem_uart_cr2),
+    MSH_MEM_REG(UART3_TypeDef, CR3, msh_mem_uart3_cr3),
+    MSH_MEM_REG_RAW(UART3_TypeDef, CR4),
+    MSH_MEM_REG(UART3_TypeDef, CR6, msh_mem_uart3_cr6),
+};
+
+static const msh_mem_field_t msh_mem_tim2_cr1[] = {
+    MSH_MEM_FIELD(TIM2, CR1, ARPE), MSH_MEM_FIELD(TIM2, CR1, OPM), MSH_MEM_FIELD(TIM2, CR1, URS),
+    MSH_MEM_FIELD(TIM2, CR1, UDIS), MSH_MEM_FIELD(TIM2, CR1, CEN),
+};
+static const msh_mem_field_t msh_mem_tim2_ier[] = {
+    MSH_MEM_FIELD(TIM2, IER, CC3IE), MSH_MEM_FIELD(TIM2, IER, CC2IE),
+    MSH_MEM_FIELD(TIM2, IER, CC1IE), MSH_MEM_FIELD(TIM2, IER, UIE),
+};
+static const msh_mem_field_t msh_mem_tim2_sr1[] = {
+    MSH_MEM_FIELD(TIM2, SR1, CC3IF), MSH_MEM_FIELD(TIM2, SR1, CC2IF),
+    MSH_MEM_FIELD(TIM2, SR1, CC1IF), MSH_MEM_FIELD(TIM2, SR1, UIF),
+};
+static const msh_mem_field_t msh_mem_tim2_sr2[] = {
+    MSH_MEM_FIELD(TIM2, SR2, CC3OF), MSH_MEM_FIELD(TIM2, SR2, CC2OF), MSH_MEM_FIELD(TIM2, SR2, CC1OF),
+};
+static const msh_mem_field_t msh_mem_tim2_ccer1[] = {
+    MSH_MEM_FIELD(TIM2, CCER1, CC2P), MSH_MEM_FIELD(TIM2, CCER1, CC2E),
+    MSH_MEM_FIELD(TIM2, CCER1, CC1P), MSH_MEM_FIELD(TIM2, CCER1, CC1E),
+};
+static const msh_mem_field_t msh_mem_tim2_ccer2[] = {
+    MSH_MEM_FIELD(TIM2, CCER2, CC3P), MSH_MEM_FIELD(TIM2, CCER2, CC3E),
+};
+static const msh_mem_reg_t msh_mem_tim2_regs[] = {
+    MSH_MEM_REG(TIM2_TypeDef, CR1, msh_mem_tim2_cr1),
+    MSH_MEM_REG(TIM2_TypeDef, IER, msh_mem_tim2_ier),
+    MSH_MEM_REG(TIM2_TypeDef, SR1, msh_mem_tim2_sr1),
+    MSH_MEM_REG(TIM2_TypeDef, SR2, msh_mem_tim2_sr2),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCMR1),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCMR2),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCMR3),
+    MSH_MEM_REG(TIM2_TypeDef, CCER1, msh_mem_tim2_ccer1),
+    MSH_MEM_REG(TIM2_TypeDef, CCER2, msh_mem_tim2_ccer2),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CNTRH),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CNTRL),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, PSCR),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, ARRH),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, ARRL),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCR1H),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCR1L),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCR2H),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCR2L),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCR3H),
+    MSH_MEM_REG_RAW(TIM2_TypeDef, CCR3L),
+};
+
+static const msh_mem_field_t msh_mem_tim4_cr1[] = {
+    MSH_MEM_FIELD(TIM4, CR1, ARPE), MSH_MEM_FIELD(TIM4, CR1, OPM), MSH_MEM_FIELD(TIM4, CR1, URS),
+    MSH_MEM_FIELD(TIM4, CR1, UDIS), MSH_MEM_FIELD(TIM4, CR1, CEN),
+};
+static const msh_mem_field_t msh_mem_tim4_ier[] = {
+    MSH_MEM_FIELD(TIM4, IER, UIE),
+};
+static const msh_mem_field_t msh_mem_tim4_sr1[] = {
+    MSH_MEM_FIELD(TIM4, SR1, UIF),
+};
+static const msh_mem_reg_t msh_mem_tim4_regs[] = {
+    MSH_MEM_REG(TIM4_TypeDef, CR1, msh_mem_tim4_cr1),
+    MSH_MEM_REG(TIM4_TypeDef, IER, msh_mem_tim4_ier),
+    MSH_MEM_REG(TIM4_TypeDef, SR1, msh_mem_tim4_sr1),
+    MSH_MEM_REG_RAW(TIM4_TypeDef, EGR),
+    MSH_MEM_REG_RAW(TIM4_TypeDef, CNTR),
+    MSH_MEM_REG_RAW(TIM4_TypeDef, PSCR),
+    MSH_MEM_REG_RAW(TIM4_TypeDef, ARR),
+};
+
+static const msh_mem_periph_t msh_mem_periphs[] = {
+    MSH_MEM_PERIPH("clk", CLK_BaseAddress, msh_mem_clk_regs),
+    MSH_MEM_PERIPH("gpioa", GPIOA_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpiob", GPIOB_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpioc", GPIOC_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpiod", GPIOD_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpioe", GPIOE_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpiof", GPIOF_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpiog", GPIOG_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpioh", GPIOH_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("gpioi", GPIOI_BaseAddress, msh_mem_gpio_regs),
+    MSH_MEM_PERIPH("flash", FLASH_BaseAddress, msh_mem_flash_regs),
+    MSH_MEM_PERIPH("uart1", UART1_BaseAddress, msh_mem_uart1_regs),
+    MSH_MEM_PERIPH("uart3", UART3_BaseAddress, msh_mem_uart3_regs),
+    MSH_MEM_PERIPH("tim2", TIM2_BaseAddress, msh_mem_tim2_regs),
+    MSH_MEM_PERIPH("tim4", TIM4_BaseAddress, msh_mem_tim4_regs),
+};
+
+// mw命令参数声明：mw <addr> <bytes>
+const msh_arg_spec_t msh_mem_write_args[MSH_MEM_WRITE_ARGS_NUM] = {
+    MSH_ARG_DEF_HEX(addr, 0, FLASH_PROG_START_PHYSICAL_ADDRESS - 1),
+    MSH_ARG_DEF_BYTES(data, 1, MSH_MEM_WRITE_MAX),
+};
+
+/////////////////////////////格式化/////////////////////////////
+
+// 读取任意地址的一个字节（24位地址时使用far指针）
+static uint8_t msh_mem_read(uint32_t addr)
+{
+    return *(PointerAttr volatile uint8_t *)(MemoryAddressCast)addr;
+}
+
+// 写入digits位十六进制，返回写入后的位置
+static char *msh_mem_put_hex(char *p, uint32_t value, uint8_t digits)
+{
+    char *end = p + digits;
+
+    while (digits--)
+    {
+        p[digits] = msh_mem_hex_digits[value & 0x0F];
+        value >>= 4;
+    }
+    return end;
+}
+
+// 追加字符串，空间不足时返回NULL
+static char *msh_mem_put_str(char *p, const char *end, const char *str)
+{
+    while (*str)
+    {
+        if (p >= end)
+        {
+            return NULL;
+        }
+        *p++ = *str++;
+    }
+    return p;
+}
+
+/////////////////////////////md/////////////////////////////
+
+// md输出生成函数，每次一行：地址 + 十六进制 + ASCII，arg[0]为地址，arg[1]为剩余长度
+static uint8_t msh_mem_dump_gen(msh_stream_ctx_t *ctx, char *buf, uint8_t size)
+{
+    uint8_t data[MSH_MEM_DUMP_WIDTH];
+    uint8_t n = (ctx->arg[1] > MSH_MEM_DUMP_WIDTH) ? MSH_MEM_DUMP_WIDTH : (uint8_t)ctx->arg[1];
+    char *p = buf;
+    uint8_t i;
+
+    (void)size; // 一行最长77字节，小于MSH_STREAM_CHUNK_SIZE
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    // 每个字节只读一次
+    for (i = 0; i < n; i++)
+    {
+        data[i] = msh_mem_read(ctx->arg[0] + i);
+    }
+
+    p = msh_mem_put_hex(p, ctx->arg[0], 6);
+    *p++ = ':';
+    for (i = 0; i < MSH_MEM_DUMP_WIDTH; i++)
+    {
+        *p++ = ' ';
+        if (i < n)
+        {
+            p = msh_mem_put_hex(p, data[i], 2);
+        }
+        else
+        {
+            // 不足一行时补齐，使ASCII列对齐
+            *p++ = ' ';
+            *p++ = ' ';
+        }
+    }
+    *p++ = ' ';
+    *p++ = ' ';
+    *p++ = '|';
+    for (i = 0; i < n; i++)
+    {
+        *p++ = (data[i] >= 0x20 && data[i] < 0x7F) ? (char)data[i] : '.';
+    }
+    *p++ = '|';
+    *p++ = '\r';
+    *p++ = '\n';
+
+    ctx->arg[0] += n;
+    ctx->arg[1] -= n;
+    return (uint8_t)(p - buf);
+}
+
+// md命令：md <addr> [len] [--more]
+int msh_cmd_md(int argc, char **argv)
+{
+    int32_t addr;
+    int32_t len = MSH_MEM_DUMP_DEFAULT;
+
+    if (argc < 2 || !msh_arg_to_hex(argv[1], &addr) ||
+        (uint32_t)addr > FLASH_PROG_END_PHYSICAL_ADDRESS ||
+        (argc > 2 && strcmp(argv[2], MSH_STREAM_MORE_OPT) != 0 &&
+         (!msh_arg_to_int(argv[2], &len) || len < 1 || len > MSH_MEM_DUMP_MAX)))
+    {
+        bsp_printf("Usage: md <addr> [1..%d] [" MSH_STREAM_MORE_OPT "]\r\n", MSH_MEM_DUMP_MAX);
+        return -1;
+    }
+    // 不超出地址空间
+    if ((uint32_t)addr + (uint32_t)len > FLASH_PROG_END_PHYSICAL_ADDRESS + 1)
+    {
+        len = (int32_t)(FLASH_PROG_END_PHYSICAL_ADDRESS + 1 - (uint32_t)addr);
+    }
+    msh_stream_start(msh_mem_dump_gen, (uint32_t)addr, (uint32_t)len, msh_stream_page_opt(argc, argv));
+    return 0;
+}
+
+/////////////////////////////mw/////////////////////////////
+
+// mw命令：mw <addr> <bytes>，bytes为十六进制字节串（如 0102ff）
+int msh_cmd_mw(int argc, char **argv)
+{
+    uint32_t addr = (uint32_t)msh_arg_get(0)->i;
+    const uint8_t *data = msh_arg_get(1)->bytes.data;
+    uint8_t len = msh_arg_get(1)->bytes.len;
+    uint32_t last = addr + len - 1;
+    uint8_t i;
+
+    // EEPROM需要通过Flash驱动编程，写入范围不能跨越EEPROM边界
+    if (addr >= FLASH_DATA_START_PHYSICAL_ADDRESS && last <= FLASH_DATA_END_PHYSICAL_ADDRESS)
+    {
+        FLASH_Unlock(FLASH_MEMTYPE_DATA);
+        for (i = 0; i < len; i++)
+        {
+            FLASH_ProgramByte(addr + i, data[i]);
+            FLASH_WaitForLastOperation(FLASH_MEMTYPE_DATA);
+        }
+        FLASH_Lock(FLASH_MEMTYPE_DATA);
+        return 0;
+    }
+    if ((addr <= FLASH_DATA_END_PHYSICAL_ADDRESS && last >= FLASH_DATA_START_PHYSICAL_ADDRESS) ||
+        last >= FLASH_PROG_START_PHYSICAL_ADDRESS)
+    {
+        bsp_printf("Range crosses EEPROM or program memory\r\n");
+        return -1;
+    }
+    // RAM或外设寄存器
+    for (i = 0; i < len; i++)
+    {
+        *(volatile uint8_t *)(uint16_t)(addr + i) = data[i];
+    }
+    return 0;
+}
+
+/////////////////////////////regs/////////////////////////////
+
+// 显示一个寄存器：名称、地址、数值及位域
+static uint8_t msh_mem_reg_format(const msh_mem_periph_t *periph, const msh_mem_reg_t *reg,
+                                  char *buf, uint8_t size)
+{
+    uint16_t addr = periph->base + reg->offset;
+    const char *end = buf + size - 3; // 保留"\r\n"和结束符
+    char *p = buf;
+    char *next;
+    uint8_t value;
+    uint8_t i;
+
+    p += bsp_snprintf(p, size, "  %-8s %04X = ", reg->name, addr);
+    if (reg->flags & MSH_MEM_REG_NOREAD)
+    {
+        p = msh_mem_put_str(p, end, "--");
+    }
+    else
+    {
+        value = *(volatile uint8_t *)addr;
+        p = msh_mem_put_hex(p, value, 2);
+        *p++ = ' ';
+        for (i = 0; i < reg->field_num; i++)
+        {
+            const msh_mem_field_t *field = &reg->fields[i];
+            uint8_t mask = field->mask;
+            uint8_t v = value & mask;
+
+            if (v == 0)
+            {
+                continue;
+            }
+            next = msh_mem_put_str(p, end, " ");
+            next = (next != NULL) ? msh_mem_put_str(next, end, field->name) : NULL;
+            // 多位字段显示数值
+            if (next != NULL && (mask & (mask - 1)) != 0)
+            {
+                while ((mask & 0x01) == 0)
+                {
+                    mask >>= 1;
+                    v >>= 1;
+                }
+                if (next + 2 <= end)
+                {
+                    *next++ = '=';
+                    *next++ = msh_mem_hex_digits[v & 0x0F];
+                }
+                else
+                {
+                    next = NULL;
+                }
+            }
+            if (next == NULL)
+            {
+                break; // 行已满，省略剩余字段
+            }
+            p = next;
+        }
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    *p = '\0';
+    return (uint8_t)(p - buf);
+}
+
+// regs输出生成函数，每次一个寄存器，arg[0]为外设序号
+static uint8_t msh_mem_regs_gen(msh_stream_ctx_t *ctx, char *buf, uint8_t size)
+{
+    const msh_mem_periph_t *periph = &msh_mem_periphs[ctx->arg[0]];
+
+    if (ctx->index == 0)
+    {
+        return (uint8_t)bsp_snprintf(buf, size, "%s @%04X\r\n", periph->name, periph->base);
+    }
+    if (ctx->index > periph->reg_num)
+    {
+        return 0;
+    }
+    return msh_mem_reg_format(periph, &periph->regs[ctx->index - 1], buf, size);
+}
+
+// regs命令：regs [periph]
+int msh_cmd_regs(int argc, char **argv)
+{
+    uint8_t i;
+
+    for (i = 0; argc > 1 && i < MSH_MEM_ARRAY_NUM(msh_mem_periphs); i++)
+    {
+        if (strcmp(argv[1], msh_mem_periphs[i].name) == 0)
+        {
+            msh_stream_start(msh_mem_regs_gen, i, 0, msh_stream_page_opt(argc, argv));
+            return 0;
+        }
+    }
+
+    bsp_printf("Usage: regs <periph>\r\n ");
+    for (i = 0; i < MSH_MEM_ARRAY_NUM(msh_mem_periphs); i++)
+    {
+        bsp_printf(" %s", msh_mem_periphs[i].name);
+    }
+    bsp_printf("\r\n");
+    return (argc > 1) ? -1 : 0;
+}
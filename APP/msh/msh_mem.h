@@ -0,0 +1,32 @@
+#ifndef __MSH_MEM_H__
+#define __MSH_MEM_H__
+
+#include "bsp_sys_pub.h"
+#include "msh.h"
+
+/*
+ * 内存/寄存器查看命令，输出由msh_stream逐行发送，不阻塞调度
+ *
+ * md <addr> [len] [--more]   十六进制转储，地址为24位（可访问整个Flash）
+ * mw <addr> <bytes>          写RAM/外设寄存器，EEPROM地址通过Flash驱动编程
+ * regs [periph]              按stm8s.h寄存器定义显示外设寄存器并解码位域，省略时列出外设
+ *
+ * 注意：读取部分寄存器有副作用（如UART的SR之后读DR会清除标志），
+ * regs对这类寄存器不读取，md读取外设地址时需自行注意
+ */
+
+#define MSH_MEM_DUMP_WIDTH      16     // md每行字节数
+#define MSH_MEM_DUMP_DEFAULT    64     // md默认长度
+#define MSH_MEM_DUMP_MAX        0x1000 // md单次最大长度
+#define MSH_MEM_WRITE_MAX       16     // mw单次最大字节数
+
+// mw命令参数声明
+#define MSH_MEM_WRITE_ARGS_NUM  2
+extern const msh_arg_spec_t msh_mem_write_args[MSH_MEM_WRITE_ARGS_NUM];
+
+// 命令
+int msh_cmd_md(int argc, char **argv);
+int msh_cmd_mw(int argc, char **argv);
+int msh_cmd_regs(int argc, char **argv);
+
+#endif
@@ -0,0 +1,284 @@
+#include "msh_rpc.h"
+#include "msh.h"
+
+// 接收状态
+typedef enum
+{
+    MSH_RPC_RX_SYNC = 0, // 等待同步字节
+    MSH_RPC_RX_LEN,      // 等待长度
+    MSH_RPC_RX_DATA,     // 接收数据和CRC
+} msh_rpc_rx_state_t;
+
+// RPC状态数据
+static struct
+{
+    bool active;                          // 是否处于RPC模式
+    msh_session_t *owner;                 // 处于RPC模式的会话（同一时间只允许一个）
+    msh_rpc_rx_state_t state;             // 接收状态
+    uint8_t rx_len;                       // 当前帧LEN
+    uint8_t rx_idx;                       // 已接收的数据字节数
+    uint32_t rx_time;                     // 最近一次收到字节的时间
+    uint8_t rx_buf[MSH_RPC_FRAME_MAX + 3]; // LEN + 数据 + CRC
+
+    uint8_t tx_buf[MSH_RPC_FRAME_MAX + 4]; // SYNC + LEN + 数据 + CRC，保存上一次应答
+    uint8_t tx_len;                       // 上一次应答的数据长度（LEN）
+    bool tx_valid;                        // 上一次应答是否有效
+    bool tx_trunc;                        // 输出是否被截断
+} msh_rpc = {0};
+
+// CRC-16/CCITT-FALSE半字节查找表
+static const uint16_t msh_rpc_crc_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+// 计算CRC
+static uint16_t msh_rpc_crc16(const uint8_t *data, uint8_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--)
+    {
+        uint8_t b = *data++;
+        crc = (crc << 4) ^ msh_rpc_crc_table[(uint8_t)(crc >> 12) ^ (b >> 4)];
+        crc = (crc << 4) ^ msh_rpc_crc_table[(uint8_t)(crc >> 12) ^ (b & 0x0F)];
+    }
+    return crc;
+}
+
+// 追加应答数据，超出帧长度时标记截断
+static void msh_rpc_put(uint8_t data)
+{
+    if (msh_rpc.tx_len >= MSH_RPC_FRAME_MAX)
+    {
+        msh_rpc.tx_trunc = TRUE;
+        return;
+    }
+    msh_rpc.tx_buf[2 + msh_rpc.tx_len++] = data;
+}
+
+// 命令在RPC模式下追加二进制结果
+void msh_rpc_write(const uint8_t *data, uint8_t len)
+{
+    while (len--)
+    {
+        msh_rpc_put(*data++);
+    }
+}
+
+// 标准输出重定向函数，收集命令输出
+static void msh_rpc_capture(const uint8_t *data, uint16_t len)
+{
+    while (len--)
+    {
+        msh_rpc_put(*data++);
+    }
+}
+
+// 开始组织应答
+static void msh_rpc_reply_begin(uint8_t seq)
+{
+    msh_rpc.tx_len = 0;
+    msh_rpc.tx_trunc = FALSE;
+    msh_rpc_put(seq);
+    msh_rpc_put(MSH_RPC_OK); // 状态，结束时回填
+    msh_rpc_put(0);          // 返回值，结束时回填
+    msh_rpc_put(0);
+}
+
+// 结束应答，回填状态并发送
+static void msh_rpc_reply_end(uint8_t status, int ret)
+{
+    uint16_t crc;
+
+    if (status == MSH_RPC_OK && msh_rpc.tx_trunc)
+    {
+        status = MSH_RPC_ERR_TRUNC;
+    }
+    msh_rpc.tx_buf[0] = MSH_RPC_SYNC;
+    msh_rpc.tx_buf[1] = msh_rpc.tx_len;
+    msh_rpc.tx_buf[3] = status;
+    msh_rpc.tx_buf[4] = (uint8_t)ret;
+    msh_rpc.tx_buf[5] = (uint8_t)((uint16_t)ret >> 8);
+    crc = msh_rpc_crc16(&msh_rpc.tx_buf[1], msh_rpc.tx_len + 1);
+    msh_rpc.tx_buf[2 + msh_rpc.tx_len] = (uint8_t)crc;
+    msh_rpc.tx_buf[3 + msh_rpc.tx_len] = (uint8_t)(crc >> 8);
+    msh_rpc.tx_valid = TRUE;
+
+    uart_stdout_write(msh_rpc.tx_buf, msh_rpc.tx_len + 4);
+}
+
+// 处理一帧完整的请求，rx_buf[0]为LEN
+static void msh_rpc_handle_frame(void)
+{
+    uint8_t *data = &msh_rpc.rx_buf[1];
+    uint8_t len = msh_rpc.rx_len;
+    uint8_t seq = data[0];
+    uint8_t id = data[1];
+    const msh_cmd_t *cmd;
+    char *argv[MSH_ARG_MAX_COUNT];
+    int argc = 0;
+    int ret = 0;
+    uint8_t pos;
+    uint8_t next_len;
+    int8_t status;
+    void (*hook)(const uint8_t *data, uint16_t len);
+
+    // 重发请求，直接回复上一次的应答
+    if (msh_rpc.tx_valid && msh_rpc.tx_len > 0 && msh_rpc.tx_buf[2] == seq)
+    {
+        uart_stdout_write(msh_rpc.tx_buf, msh_rpc.tx_len + 4);
+        return;
+    }
+
+    msh_rpc_reply_begin(seq);
+
+    if (id == MSH_RPC_CMD_EXIT)
+    {
+        msh_rpc_reply_end(MSH_RPC_OK, 0);
+        msh_rpc_exit();
+        return;
+    }
+    if (id == MSH_RPC_CMD_LIST)
+    {
+        for (pos = 0; pos < msh_cmd_count(); pos++)
+        {
+            const char *name = msh_cmd_get(pos)->name;
+            msh_rpc_write((const uint8_t *)name, (uint8_t)strlen(name));
+            msh_rpc_put('\n');
+        }
+        msh_rpc_reply_end(MSH_RPC_OK, msh_cmd_count());
+        return;
+    }
+
+    cmd = msh_cmd_get(id);
+    if (cmd == NULL)
+    {
+        msh_rpc_reply_end(MSH_RPC_ERR_CMD, 0);
+        return;
+    }
+
+    // 拆分长度前缀参数，原地添加结束符：先读下一个长度字节，再用结束符覆盖它
+    argv[argc++] = (char *)cmd->name;
+    pos = 2;
+    next_len = data[pos];
+    while (pos < len)
+    {
+        uint8_t arg_len = next_len;
+
+        if (argc >= MSH_ARG_MAX_COUNT || pos + 1 + arg_len > len)
+        {
+            msh_rpc_reply_end(MSH_RPC_ERR_ARG, 0);
+            return;
+        }
+        argv[argc++] = (char *)&data[pos + 1];
+        pos += 1 + arg_len;
+        next_len = data[pos];
+        data[pos] = '\0';
+    }
+
+    // 执行期间将printf输出收集到应答中，之后恢复会话的输出
+    hook = uart_get_stdout_hook();
+    uart_set_stdout_hook(msh_rpc_capture);
+    status = msh_cmd_invoke(cmd, argc, argv, &ret);
+    uart_set_stdout_hook(hook);
+
+    msh_rpc_reply_end((status == MSH_EXEC_OK) ? MSH_RPC_OK : MSH_RPC_ERR_ARG, ret);
+}
+
+// RPC模式下的接收字节处理
+void msh_rpc_input(uint8_t c)
+{
+    uint32_t now = sys_timer_get_system_time_ms();
+
+    // 帧内超时，丢弃半帧重新同步
+    if (msh_rpc.state != MSH_RPC_RX_SYNC && now - msh_rpc.rx_time > MSH_RPC_TIMEOUT_MS)
+    {
+        msh_rpc.state = MSH_RPC_RX_SYNC;
+    }
+    msh_rpc.rx_time = now;
+
+    switch (msh_rpc.state)
+    {
+    case MSH_RPC_RX_SYNC:
+        if (c == MSH_RPC_SYNC)
+        {
+            msh_rpc.state = MSH_RPC_RX_LEN;
+        }
+        break;
+
+    case MSH_RPC_RX_LEN:
+        // 至少包含SEQ和CMD_ID
+        if (c < 2 || c > MSH_RPC_FRAME_MAX)
+        {
+            msh_rpc.state = (c == MSH_RPC_SYNC) ? MSH_RPC_RX_LEN : MSH_RPC_RX_SYNC;
+            break;
+        }
+        msh_rpc.rx_buf[0] = c;
+        msh_rpc.rx_len = c;
+        msh_rpc.rx_idx = 0;
+        msh_rpc.state = MSH_RPC_RX_DATA;
+        break;
+
+    case MSH_RPC_RX_DATA:
+        msh_rpc.rx_buf[1 + msh_rpc.rx_idx++] = c;
+        if (msh_rpc.rx_idx == msh_rpc.rx_len + 2)
+        {
+            uint16_t crc = msh_rpc_crc16(msh_rpc.rx_buf, msh_rpc.rx_len + 1);
+
+            msh_rpc.state = MSH_RPC_RX_SYNC;
+            // CRC错误的帧直接丢弃，由上位机超时重发
+            if ((uint8_t)crc == msh_rpc.rx_buf[1 + msh_rpc.rx_len] &&
+                (uint8_t)(crc >> 8) == msh_rpc.rx_buf[2 + msh_rpc.rx_len])
+            {
+                msh_rpc_handle_frame();
+            }
+        }
+        break;
+
+    default:
+        msh_rpc.state = MSH_RPC_RX_SYNC;
+        break;
+    }
+}
+
+// 当前会话进入RPC模式
+bool msh_rpc_enter(void)
+{
+    if (msh_rpc.active && msh_rpc.owner != msh_session_current())
+    {
+        return FALSE; // 其他会话正在使用
+    }
+    msh_rpc.state = MSH_RPC_RX_SYNC;
+    msh_rpc.tx_valid = FALSE;
+    msh_rpc.owner = msh_session_current();
+    msh_rpc.active = TRUE;
+    bsp_log_hold(TRUE); // 二进制日志记录会混入应答帧，RPC期间只缓存
+    return TRUE;
+}
+
+// 退出RPC模式
+void msh_rpc_exit(void)
+{
+    msh_rpc.active = FALSE;
+    msh_rpc.owner = NULL;
+    bsp_log_hold(FALSE);
+}
+
+// 当前会话是否处于RPC模式
+bool msh_rpc_active(void)
+{
+    return (msh_rpc.active && msh_rpc.owner == msh_session_current()) ? TRUE : FALSE;
+}
+
+// 进入RPC模式命令
+int msh_cmd_rpc(int argc, char **argv)
+{
+    if (!msh_rpc_enter())
+    {
+        bsp_printf("RPC mode busy on another session\r\n");
+        return -1;
+    }
+    bsp_printf("Entering binary RPC mode\r\n");
+    return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef __MSH_RPC_H__
+#define __MSH_RPC_H__
+
+#include "bsp_sys_pub.h"
+
+/*
+ * MSH二进制RPC模式，供自动化测试高频调用命令，与文本模式共用msh_cmd_t命令表
+ *
+ * 请求帧：SYNC(0xA5) LEN SEQ CMD_ID ARGS... CRC_L CRC_H
+ * 应答帧：SYNC(0xA5) LEN SEQ STATUS RET_L RET_H DATA... CRC_L CRC_H
+ *
+ * LEN    从SEQ开始到CRC之前的字节数
+ * CRC    CRC-16/CCITT-FALSE，覆盖LEN到CRC之前的所有字节，低字节在前
+ * CMD_ID 命令在命令表中的下标，0xFE列出命令表，0xFF退出RPC模式
+ * ARGS   依次为 长度(1字节) + 参数内容，参数内容可以是任意二进制数据
+ * RET    命令处理函数返回值（int16，低字节在前）
+ * DATA   命令执行期间的输出（printf或msh_rpc_write），超长部分被截断
+ *
+ * 收到与上一帧相同SEQ的请求时直接重发上一次的应答，不重复执行命令
+ */
+
+#define MSH_RPC_SYNC            0xA5
+#define MSH_RPC_FRAME_MAX       64    // LEN最大值
+#define MSH_RPC_TIMEOUT_MS      50    // 帧内字节间隔超时
+
+#define MSH_RPC_CMD_LIST        0xFE  // 列出命令表
+#define MSH_RPC_CMD_EXIT        0xFF  // 退出RPC模式
+
+// 应答状态
+#define MSH_RPC_OK              0
+#define MSH_RPC_ERR_CMD         1     // 命令编号无效
+#define MSH_RPC_ERR_ARG         2     // 参数格式或检查失败
+#define MSH_RPC_ERR_TRUNC       3     // 已执行，但输出被截断
+
+// 当前会话进入/退出RPC模式，同一时间只允许一个会话处于RPC模式
+bool msh_rpc_enter(void);
+void msh_rpc_exit(void);
+// 当前会话是否处于RPC模式
+bool msh_rpc_active(void);
+
+// RPC模式下的接收字节处理
+void msh_rpc_input(uint8_t c);
+
+// 命令在RPC模式下追加二进制结果
+void msh_rpc_write(const uint8_t *data, uint8_t len);
+
+// 进入RPC模式命令
+int msh_cmd_rpc(int argc, char **argv);
+
+#endif
@@ -0,0 +1,390 @@
+#include "msh_script.h"
+#include "msh_rpc.h"
+#include "mtos_task.h"
+
+// 后台任务
+typedef struct
+{
+    char line[MSH_CMD_MAX_LENGTH]; // 要执行的命令行
+    uint16_t remain;               // 剩余执行次数，0表示一直执行（every）
+    uint16_t period;               // 执行间隔（毫秒）
+    uint32_t last_time;            // 上次执行时间
+    msh_session_t *owner;          // 启动任务的会话，输出到该会话
+    uint8_t used;                  // 是否在使用
+} msh_job_t;
+
+static msh_job_t msh_jobs[MSH_JOB_MAX];
+
+static const char *const msh_script_ops[] = {"list", "save", "del", "show", NULL};
+
+// script命令参数声明：script <list|save|del|show> [name] [body]
+const msh_arg_spec_t msh_script_args[MSH_SCRIPT_ARGS_NUM] = {
+    MSH_ARG_DEF_ENUM(op, msh_script_ops),
+    MSH_ARG_OPT_STR(name, 1, MSH_SCRIPT_NAME_LEN - 1),
+    MSH_ARG_OPT_STR(body, 1, MSH_SCRIPT_BODY_LEN - 1),
+};
+
+/////////////////////////////后台任务/////////////////////////////
+
+// 添加后台任务，返回任务编号，失败返回-1
+static int8_t msh_job_add(uint16_t count, uint16_t period, int argc, char **argv)
+{
+    uint8_t i;
+
+    for (i = 0; i < MSH_JOB_MAX; i++)
+    {
+        if (!msh_jobs[i].used)
+        {
+            break;
+        }
+    }
+    if (i >= MSH_JOB_MAX)
+    {
+        bsp_printf("No free job slot\r\n");
+        return -1;
+    }
+    if (!msh_join_args(msh_jobs[i].line, sizeof(msh_jobs[i].line), argc, argv))
+    {
+        bsp_printf("Command too long\r\n");
+        return -1;
+    }
+    msh_jobs[i].remain = count;
+    msh_jobs[i].period = period;
+    // 第一次调度立即执行
+    msh_jobs[i].last_time = sys_timer_get_system_time_ms() - period;
+    msh_jobs[i].owner = msh_session_current();
+    msh_jobs[i].used = 1;
+    mtos_task_resume(MSH_JOB_TASK_NAME);
+    return (int8_t)i;
+}
+
+// 后台任务处理函数，每次最多执行每个任务一次，保证shell和其他任务的响应。
+// 没有后台任务时挂起自己，不再按1ms周期唤醒CPU
+void msh_job_process(void)
+{
+    char line[MSH_CMD_MAX_LENGTH];
+    msh_session_t *prev;
+    uint8_t used = 0;
+    uint8_t i;
+
+    for (i = 0; i < MSH_JOB_MAX; i++)
+    {
+        msh_job_t *job = &msh_jobs[i];
+        uint32_t now = sys_timer_get_system_time_ms();
+
+        if (!job->used || now - job->last_time < job->period)
+        {
+            continue;
+        }
+
+        // 在启动任务的会话中执行，该会话处于RPC模式时暂停，避免输出打乱帧
+        prev = msh_session_switch(job->owner);
+        if (msh_rpc_active())
+        {
+            msh_session_switch(prev);
+            continue;
+        }
+        job->last_time = now;
+
+        // 命令行执行时会被修改，使用副本
+        strcpy(line, job->line);
+        msh_exec_line(line);
+        msh_session_switch(prev);
+
+        // 执行的命令可能已经停止了该任务
+        if (job->used && job->remain > 0 && --job->remain == 0)
+        {
+            job->used = 0;
+        }
+    }
+    for (i = 0; i < MSH_JOB_MAX; i++)
+    {
+        used |= msh_jobs[i].used;
+    }
+    if (!used)
+    {
+        mtos_task_suspend(MSH_JOB_TASK_NAME);
+    }
+}
+
+// repeat命令：repeat <count> <cmd...>，在后台连续执行count次
+int msh_cmd_repeat(int argc, char **argv)
+{
+    int32_t count;
+    int8_t id;
+
+    if (argc < 3 || !msh_arg_to_int(argv[1], &count) || count < 1 || count > 0xFFFF)
+    {
+        bsp_printf("Usage: repeat <1..65535> <cmd...>\r\n");
+        return -1;
+    }
+    id = msh_job_add((uint16_t)count, 0, argc - 2, &argv[2]);
+    if (id >= 0)
+    {
+        bsp_printf("Job %d started\r\n", id);
+    }
+    return id;
+}
+
+// every命令：every <ms> <cmd...>，在后台周期执行，直到stop
+int msh_cmd_every(int argc, char **argv)
+{
+    int32_t period;
+    int8_t id;
+
+    if (argc < 3 || !msh_arg_to_int(argv[1], &period) || period < 1 || period > 0xFFFF)
+    {
+        bsp_printf("Usage: every <1..65535 ms> <cmd...>\r\n");
+        return -1;
+    }
+    id = msh_job_add(0, (uint16_t)period, argc - 2, &argv[2]);
+    if (id >= 0)
+    {
+        bsp_printf("Job %d started\r\n", id);
+    }
+    return id;
+}
+
+// jobs命令：列出后台任务
+int msh_cmd_jobs(int argc, char **argv)
+{
+    uint8_t i;
+
+    for (i = 0; i < MSH_JOB_MAX; i++)
+    {
+        if (msh_jobs[i].used)
+        {
+            if (msh_jobs[i].remain > 0)
+            {
+                bsp_printf("  %d: repeat %u \"%s\"\r\n", i, msh_jobs[i].remain, msh_jobs[i].line);
+            }
+            else
+            {
+                bsp_printf("  %d: every %ums \"%s\"\r\n", i, msh_jobs[i].period, msh_jobs[i].line);
+            }
+        }
+    }
+    return 0;
+}
+
+// stop命令：stop [id]，省略id时停止全部后台任务
+int msh_cmd_stop(int argc, char **argv)
+{
+    int32_t id;
+    uint8_t i;
+
+    if (argc < 2)
+    {
+        for (i = 0; i < MSH_JOB_MAX; i++)
+        {
+            msh_jobs[i].used = 0;
+        }
+        return 0;
+    }
+    if (!msh_arg_to_int(argv[1], &id) || id < 0 || id >= MSH_JOB_MAX)
+    {
+        bsp_printf("Usage: stop [0..%d]\r\n", MSH_JOB_MAX - 1);
+        return -1;
+    }
+    msh_jobs[id].used = 0;
+    return 0;
+}
+
+/////////////////////////////EEPROM脚本/////////////////////////////
+
+// 脚本槽地址
+static uint32_t msh_script_addr(uint8_t slot)
+{
+    return MSH_SCRIPT_EEPROM_ADDR + (uint32_t)slot * MSH_SCRIPT_SIZE;
+}
+
+// 从EEPROM读取字符串，最多读取size-1个字符
+static void msh_script_read(uint32_t addr, char *buf, uint8_t size)
+{
+    uint8_t i;
+
+    for (i = 0; i < size - 1; i++)
+    {
+        buf[i] = (char)FLASH_ReadByte(addr + i);
+        if (buf[i] == '\0')
+        {
+            break;
+        }
+    }
+    buf[i] = '\0';
+}
+
+// 槽是否为空（EEPROM出厂值为0x00，擦除后的0xFF也视为空）
+static bool msh_script_empty(uint8_t slot)
+{
+    uint8_t c = FLASH_ReadByte(msh_script_addr(slot));
+    return (c == 0x00 || c == 0xFF) ? TRUE : FALSE;
+}
+
+// 按名称查找脚本槽，未找到返回-1
+static int8_t msh_script_find(const char *name)
+{
+    char slot_name[MSH_SCRIPT_NAME_LEN];
+    uint8_t i;
+
+    for (i = 0; i < MSH_SCRIPT_NUM; i++)
+    {
+        if (msh_script_empty(i))
+        {
+            continue;
+        }
+        msh_script_read(msh_script_addr(i), slot_name, sizeof(slot_name));
+        if (strcmp(slot_name, name) == 0)
+        {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+// 写入EEPROM，只写入与原内容不同的字节以减少擦写时间和次数
+static void msh_script_write(uint32_t addr, const char *data, uint8_t len)
+{
+    uint8_t i;
+
+    FLASH_Unlock(FLASH_MEMTYPE_DATA);
+    for (i = 0; i < len; i++)
+    {
+        if (FLASH_ReadByte(addr + i) != (uint8_t)data[i])
+        {
+            FLASH_ProgramByte(addr + i, (uint8_t)data[i]);
+            FLASH_WaitForLastOperation(FLASH_MEMTYPE_DATA);
+        }
+    }
+    FLASH_Lock(FLASH_MEMTYPE_DATA);
+}
+
+// 保存脚本，同名脚本被覆盖
+static bool msh_script_save(const char *name, const char *body)
+{
+    char name_buf[MSH_SCRIPT_NAME_LEN] = {0};
+    int8_t slot = msh_script_find(name);
+    uint8_t i;
+
+    if (slot < 0)
+    {
+        for (i = 0; i < MSH_SCRIPT_NUM; i++)
+        {
+            if (msh_script_empty(i))
+            {
+                slot = (int8_t)i;
+                break;
+            }
+        }
+    }
+    if (slot < 0)
+    {
+        return FALSE;
+    }
+
+    // 先清除名称的第一个字节使槽为空（覆盖同名脚本时原名称仍有效），再写内容，最后写名称。
+    // 写入过程中掉电时槽为空（原脚本丢失）或为完整的新脚本，不会留下名称有效但内容残缺的脚本
+    strncpy(name_buf, name, sizeof(name_buf) - 1);
+    msh_script_write(msh_script_addr(slot), "", 1);
+    msh_script_write(msh_script_addr(slot) + MSH_SCRIPT_NAME_LEN, body, (uint8_t)strlen(body) + 1);
+    msh_script_write(msh_script_addr(slot), name_buf, sizeof(name_buf));
+    return TRUE;
+}
+
+// 执行名称为name的脚本
+bool msh_script_run(const char *name)
+{
+    char body[MSH_SCRIPT_BODY_LEN];
+    int8_t slot = msh_script_find(name);
+
+    if (slot < 0)
+    {
+        return FALSE;
+    }
+    msh_script_read(msh_script_addr(slot) + MSH_SCRIPT_NAME_LEN, body, sizeof(body));
+    msh_exec_line(body);
+    return TRUE;
+}
+
+// script命令：script <list|save|del|show> [name] [body]
+int msh_cmd_script(int argc, char **argv)
+{
+    char buf[MSH_SCRIPT_BODY_LEN];
+    const char *name = (argc > 2) ? msh_arg_get(1)->s : NULL;
+    int8_t slot;
+    uint8_t i;
+
+    switch (msh_arg_get(0)->i)
+    {
+    case 0: // list
+        for (i = 0; i < MSH_SCRIPT_NUM; i++)
+        {
+            if (!msh_script_empty(i))
+            {
+                msh_script_read(msh_script_addr(i), buf, MSH_SCRIPT_NAME_LEN);
+                bsp_printf("  %s\r\n", buf);
+            }
+        }
+        return 0;
+
+    case 1: // save
+        if (name == NULL || argc < 4)
+        {
+            break;
+        }
+        if (!msh_script_save(name, msh_arg_get(2)->s))
+        {
+            bsp_printf("No free script slot\r\n");
+            return -1;
+        }
+        return 0;
+
+    case 2: // del
+        if (name == NULL)
+        {
+            break;
+        }
+        slot = msh_script_find(name);
+        if (slot >= 0)
+        {
+            msh_script_write(msh_script_addr(slot), "", 1);
+        }
+        return 0;
+
+    case 3: // show
+        if (name == NULL)
+        {
+            break;
+        }
+        slot = msh_script_find(name);
+        if (slot < 0)
+        {
+            bsp_printf("Script not found: %s\r\n", name);
+            return -1;
+        }
+        msh_script_read(msh_script_addr(slot) + MSH_SCRIPT_NAME_LEN, buf, sizeof(buf));
+        bsp_printf("%s\r\n", buf);
+        return 0;
+
+    default:
+        break;
+    }
+    msh_arg_print_usage(argv[0], msh_script_args, MSH_SCRIPT_ARGS_NUM);
+    return -1;
+}
+
+// run命令：run <name>，执行EEPROM中的脚本
+int msh_cmd_run(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        bsp_printf("Usage: run <name>\r\n");
+        return -1;
+    }
+    if (!msh_script_run(argv[1]))
+    {
+        bsp_printf("Script not found: %s\r\n", argv[1]);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,37 @@
+#ifndef __MSH_SCRIPT_H__
+#define __MSH_SCRIPT_H__
+
+#include "bsp_sys_pub.h"
+#include "msh.h"
+
+// 后台任务配置
+#define MSH_JOB_MAX             2     // 同时运行的repeat/every任务数量
+#define MSH_JOB_TASK_NAME       "msh_job" // 后台任务的调度任务名，没有后台任务时挂起
+
+// EEPROM脚本配置
+#define MSH_SCRIPT_EEPROM_ADDR  FLASH_DATA_START_PHYSICAL_ADDRESS // 脚本区起始地址
+#define MSH_SCRIPT_NUM          4     // 脚本槽数量
+#define MSH_SCRIPT_SIZE         64    // 每个脚本槽大小（名称 + 内容）
+#define MSH_SCRIPT_NAME_LEN     8     // 名称长度（含结束符）
+#define MSH_SCRIPT_BODY_LEN     (MSH_SCRIPT_SIZE - MSH_SCRIPT_NAME_LEN) // 内容长度（含结束符）
+#define MSH_SCRIPT_BOOT_NAME    "boot" // 上电自动执行的脚本名称
+
+// script命令参数声明
+#define MSH_SCRIPT_ARGS_NUM     3
+extern const msh_arg_spec_t msh_script_args[MSH_SCRIPT_ARGS_NUM];
+
+// 后台任务处理函数（由msh_job任务周期调用）
+void msh_job_process(void);
+
+// 执行名称为name的脚本，返回FALSE表示脚本不存在
+bool msh_script_run(const char *name);
+
+// 命令
+int msh_cmd_repeat(int argc, char **argv);
+int msh_cmd_every(int argc, char **argv);
+int msh_cmd_jobs(int argc, char **argv);
+int msh_cmd_stop(int argc, char **argv);
+int msh_cmd_script(int argc, char **argv);
+int msh_cmd_run(int argc, char **argv);
+
+#endif
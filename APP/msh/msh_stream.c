@@ -0,0 +1,193 @@
+#include "msh_stream.h"
+#include "msh.h"
+#include "msh_rpc.h"
+
+#define MSH_STREAM_KEY_CTRL_C   0x03
+
+#if MSH_STREAM_CHUNK_SIZE >= UART_TX_BUF_SIZE
+#error "MSH_STREAM_CHUNK_SIZE must be smaller than UART_TX_BUF_SIZE"
+#endif
+#define MSH_STREAM_MORE_PROMPT  "--More--"
+
+// 流式输出状态数据
+static struct
+{
+    msh_stream_gen_t gen;             // 生成函数
+    msh_stream_ctx_t ctx;             // 生成函数上下文
+    char buf[MSH_STREAM_CHUNK_SIZE];  // 当前块
+    uint8_t len;                      // 当前块长度
+    uint8_t pos;                      // 当前块已输出位置
+    uint8_t page_lines;               // 每页行数，0表示不分页
+    uint8_t line_count;               // 当前页已输出行数
+    bool waiting;                     // 正在等待翻页按键
+    bool active;                      // 是否有输出在进行
+    msh_session_t *owner;             // 启动输出的会话
+} msh_stream = {0};
+
+// 结束输出并恢复提示符
+static void msh_stream_finish(void)
+{
+    msh_stream.active = FALSE;
+    msh_prompt();
+}
+
+// 开始流式输出
+bool msh_stream_start(msh_stream_gen_t gen, uint32_t arg0, uint32_t arg1, uint8_t page_lines)
+{
+    uint8_t len;
+
+    // 输出缓冲区所有会话共用，同一时间只允许一路流式输出
+    if (msh_stream.active)
+    {
+        bsp_printf("Output busy\r\n");
+        return FALSE;
+    }
+
+    msh_stream.gen = gen;
+    msh_stream.ctx.index = 0;
+    msh_stream.ctx.arg[0] = arg0;
+    msh_stream.ctx.arg[1] = arg1;
+
+    // RPC模式下输出需要收集到应答中，直接同步生成
+    if (msh_rpc_active())
+    {
+        while ((len = gen(&msh_stream.ctx, msh_stream.buf, sizeof(msh_stream.buf))) > 0)
+        {
+            uart_stdout_write((const uint8_t *)msh_stream.buf, len);
+            msh_stream.ctx.index++;
+        }
+        return TRUE;
+    }
+
+    msh_stream.len = 0;
+    msh_stream.pos = 0;
+    msh_stream.page_lines = page_lines;
+    msh_stream.line_count = 0;
+    msh_stream.waiting = FALSE;
+    msh_stream.owner = msh_session_current();
+    msh_stream.active = TRUE;
+    return TRUE;
+}
+
+// 取消输出
+void msh_stream_cancel(void)
+{
+    if (msh_stream.active)
+    {
+        bsp_printf("^C\r\n");
+        msh_stream_finish();
+    }
+}
+
+// 当前会话是否有输出在进行
+bool msh_stream_active(void)
+{
+    return (msh_stream.active && msh_stream.owner == msh_session_current()) ? TRUE : FALSE;
+}
+
+// 参数中包含--more时返回每页行数
+uint8_t msh_stream_page_opt(int argc, char **argv)
+{
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], MSH_STREAM_MORE_OPT) == 0)
+        {
+            return MSH_STREAM_PAGE_LINES;
+        }
+    }
+    return 0;
+}
+
+// 流式输出期间的按键处理
+void msh_stream_input(uint8_t c)
+{
+    if (!msh_stream_active())
+    {
+        return;
+    }
+    if (c == MSH_STREAM_KEY_CTRL_C || (msh_stream.waiting && (c == 'q' || c == 'Q')))
+    {
+        if (msh_stream.waiting)
+        {
+            bsp_printf("\r" MSH_STREAM_MORE_PROMPT "\r\n");
+        }
+        msh_stream_cancel();
+        return;
+    }
+    if (!msh_stream.waiting)
+    {
+        return; // 输出期间忽略其他输入
+    }
+
+    if (c == ' ')
+    {
+        msh_stream.line_count = 0; // 下一页
+    }
+    else if (c == '\r' || c == '\n')
+    {
+        msh_stream.line_count = msh_stream.page_lines - 1; // 下一行
+    }
+    else
+    {
+        return;
+    }
+    // 清除翻页提示
+    bsp_printf("\r        \r");
+    msh_stream.waiting = FALSE;
+}
+
+// 输出一块，调用时已切换到所属会话
+static void msh_stream_output(void)
+{
+    uint8_t start;
+
+    // 当前块已输出完，生成下一块
+    if (msh_stream.pos >= msh_stream.len)
+    {
+        msh_stream.len = msh_stream.gen(&msh_stream.ctx, msh_stream.buf, sizeof(msh_stream.buf));
+        msh_stream.ctx.index++;
+        msh_stream.pos = 0;
+        if (msh_stream.len == 0)
+        {
+            msh_stream_finish();
+            return;
+        }
+    }
+
+    // 输出到行尾或块尾，分页时按行计数
+    start = msh_stream.pos;
+    while (msh_stream.pos < msh_stream.len)
+    {
+        if (msh_stream.buf[msh_stream.pos++] == '\n' && msh_stream.page_lines > 0 &&
+            ++msh_stream.line_count >= msh_stream.page_lines)
+        {
+            msh_stream.waiting = TRUE;
+            break;
+        }
+    }
+    uart_stdout_write((const uint8_t *)&msh_stream.buf[start], msh_stream.pos - start);
+
+    if (msh_stream.waiting)
+    {
+        bsp_printf(MSH_STREAM_MORE_PROMPT);
+    }
+}
+
+// 流式输出任务处理函数，每次调度最多输出一块
+void msh_stream_process(void)
+{
+    msh_session_t *prev;
+
+    // 发送缓冲区放不下一块时等下次调度，不在写入时阻塞
+    if (!msh_stream.active || msh_stream.waiting || uart_tx_free(UART_CONSOLE_PORT) < MSH_STREAM_CHUNK_SIZE)
+    {
+        return;
+    }
+
+    // 输出到启动输出的会话
+    prev = msh_session_switch(msh_stream.owner);
+    msh_stream_output();
+    msh_session_switch(prev);
+}
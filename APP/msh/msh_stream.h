@@ -0,0 +1,46 @@
+#ifndef __MSH_STREAM_H__
+#define __MSH_STREAM_H__
+
+#include "bsp_sys_pub.h"
+
+/*
+ * MSH流式输出：命令只登记生成函数后立即返回，由msh_stream任务每次调度输出一块，
+ * 大量输出期间shell和其他任务保持响应，Ctrl-C取消，可选分页（--more）
+ */
+
+#define MSH_STREAM_CHUNK_SIZE   80    // 每块输出的最大长度（md一行77字节）
+#define MSH_STREAM_PAGE_LINES   20    // 分页模式每页行数
+#define MSH_STREAM_MORE_OPT     "--more" // 命令的分页参数
+
+// 生成函数上下文
+typedef struct
+{
+    uint16_t index;   // 已调用次数，由流模块维护
+    uint32_t arg[2];  // 命令传入的参数，生成函数可自由修改
+} msh_stream_ctx_t;
+
+// 生成函数：向buf写入一块输出，返回写入长度，返回0表示输出结束
+typedef uint8_t (*msh_stream_gen_t)(msh_stream_ctx_t *ctx, char *buf, uint8_t size);
+
+/**
+ * @brief 开始流式输出
+ * @param gen 生成函数
+ * @param arg0 参数0
+ * @param arg1 参数1
+ * @param page_lines 每页行数，0表示不分页
+ * @return 已有输出在进行时返回FALSE
+ */
+bool msh_stream_start(msh_stream_gen_t gen, uint32_t arg0, uint32_t arg1, uint8_t page_lines);
+void msh_stream_cancel(void);
+bool msh_stream_active(void);
+
+// 参数中包含--more时返回每页行数，否则返回0
+uint8_t msh_stream_page_opt(int argc, char **argv);
+
+// 流式输出期间的按键处理（Ctrl-C取消，分页时空格翻页、回车下一行、q退出）
+void msh_stream_input(uint8_t c);
+
+// 流式输出任务处理函数
+void msh_stream_process(void);
+
+#endif
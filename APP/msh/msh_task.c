@@ -1,14 +1,367 @@
 #include "bsp_sys_pub.h"
 #include "msh_task.h"
+#include "msh_rpc.h"
+#include "msh_script.h"
+#include "msh_stream.h"
+#include "msh_mem.h"
 
 extern const msh_cmd_t *__msh_cmd_start;
 extern const msh_cmd_t *__msh_cmd_end;
 
+// ps命令输出生成函数，每次输出一个任务
+static uint8_t msh_ps_gen(msh_stream_ctx_t *ctx, char *buf, uint8_t size)
+{
+    mtos_task_t *task;
+
+    if (ctx->index == 0)
+    {
+        return (uint8_t)bsp_snprintf(buf, size, MTOS_TASK_SHOW_HEADER);
+    }
+    task = mtos_task_get(ctx->index - 1);
+    if (task == NULL)
+    {
+        return 0;
+    }
+    return (uint8_t)mtos_task_snprint(task, buf, size);
+}
+
+// ps命令：列出任务
+int msh_cmd_ps(int argc, char **argv)
+{
+    msh_stream_start(msh_ps_gen, 0, 0, msh_stream_page_opt(argc, argv));
+    return 0;
+}
+
+// uart命令：显示各串口统计
+int msh_cmd_uart(int argc, char **argv)
+{
+    static const char *const names[UART_PORT_NUM] = {"uart1", "uart3"};
+    static const char *const autobaud[] = {"off", "wait", "done"};
+    uart_stats_t stats;
+    uint8_t i;
+
+    for (i = 0; i < UART_PORT_NUM; i++)
+    {
+        uart_get_stats((uart_port_t)i, &stats);
+        bsp_printf("%s baud %lu, autobaud %s, miss %u\r\n", names[i],
+                   uart_get_baudrate((uart_port_t)i), autobaud[uart_autobaud_state((uart_port_t)i)],
+                   stats.autobaud_miss);
+        bsp_printf("%s TX free %u/%u, high %u, dropped %u, blocked %u\r\n", names[i],
+                   uart_tx_free((uart_port_t)i), UART_TX_BUF_SIZE - 1,
+                   stats.tx_high_water, stats.tx_dropped, stats.tx_blocked);
+        bsp_printf("%s RX used %u/%u, dropped %u, overrun %u\r\n", names[i],
+                   uart_rx_count((uart_port_t)i), UART_RX_BUF_SIZE - 1,
+                   stats.rx_dropped, stats.rx_overrun);
+        bsp_printf("%s RX noise %u, framing %u, parity %u, frames %u, frames dropped %u\r\n", names[i],
+                   stats.rx_noise, stats.rx_framing, stats.rx_parity,
+                   stats.rx_frames, stats.rx_frames_dropped);
+        if (stats.rs485_frames > 0)
+        {
+            bsp_printf("%s RS-485 frames %u, turnaround %u us, max %u us\r\n", names[i],
+                       stats.rs485_frames, stats.rs485_turnaround, stats.rs485_turnaround_max);
+        }
+    }
+    return 0;
+}
+
+// baud命令：显示/设置控制台波特率，auto开启自动波特率检测
+int msh_cmd_baud(int argc, char **argv)
+{
+    int32_t baudrate;
+
+    if (argc < 2)
+    {
+        bsp_printf("baud %lu, autobaud %s\r\n", uart_get_baudrate(UART_CONSOLE_PORT),
+                   uart_autobaud_state(UART_CONSOLE_PORT) == UART_AUTOBAUD_WAIT ? "waiting" : "off");
+        return 0;
+    }
+    if (strcmp(argv[1], "auto") == 0)
+    {
+        bsp_printf("Send '%c' repeatedly at the new baud rate\r\n", UART_AUTOBAUD_SYNC);
+        uart_autobaud_start(UART_CONSOLE_PORT);
+        return 0;
+    }
+    if (!msh_arg_to_int(argv[1], &baudrate) || baudrate < UART_AUTOBAUD_MIN_BAUD || baudrate > 1000000L)
+    {
+        bsp_printf("Usage: baud [rate|auto]\r\n");
+        return -1;
+    }
+    uart_tx_flush(UART_CONSOLE_PORT); // 等待之前的输出按原波特率发完
+    uart_autobaud_stop(UART_CONSOLE_PORT);
+    uart_set_baudrate(UART_CONSOLE_PORT, (uint32_t)baudrate);
+    return 0;
+}
+
+// 打印一次延时测量结果
+static void msh_delay_report(const char *name, uint16_t arg, uint32_t expect, uint32_t elapsed)
+{
+    int32_t error = (int32_t)(elapsed - expect) * 1000 / (int32_t)expect;
+
+    bsp_printf("%s(%u): %lu us, error %ld permille\r\n", name, arg, elapsed, error);
+}
+
+// delay命令：以sys_timer_get_us测量延时函数的实际时间，报告误差（千分比，含调用开销）
+int msh_cmd_delay(int argc, char **argv)
+{
+    static const uint16_t us_list[] = {10, 100, 1000, 10000};
+    static const uint16_t ms_list[] = {1, 10};
+    uint32_t start;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(us_list) / sizeof(us_list[0]); i++)
+    {
+        start = sys_timer_get_us();
+        delay_us(us_list[i]);
+        msh_delay_report("delay_us", us_list[i], us_list[i], sys_timer_get_us() - start);
+    }
+    for (i = 0; i < sizeof(ms_list) / sizeof(ms_list[0]); i++)
+    {
+        start = sys_timer_get_us();
+        delay_ms(ms_list[i]);
+        msh_delay_report("delay_ms", ms_list[i], (uint32_t)ms_list[i] * 1000, sys_timer_get_us() - start);
+    }
+    bsp_printf("cycle counter resolution %u ns\r\n", sys_timer_get_resolution_ns());
+    return 0;
+}
+
+// 打印一种中断的开销统计
+static void msh_isr_report(const char *name, const sys_isr_cost_t *cost)
+{
+    uint8_t mhz = sys_timer_get_mhz();
+
+    if (cost->count == 0)
+    {
+        bsp_printf("%-8s no samples\r\n", name);
+        return;
+    }
+    bsp_printf("%-8s min %u avg %lu max %u cycles, avg %lu ns (%u samples)\r\n", name, cost->min,
+               cost->sum / cost->count, cost->max, cost->sum * 10 / cost->count * 100 / mhz, cost->count);
+}
+
+// isr命令：以TIM3周期计数测量tick中断和TIM3溢出中断的开销（含硬件进入/退出），isr [samples]
+int msh_cmd_isr(int argc, char **argv)
+{
+    sys_isr_cost_t tick;
+    sys_isr_cost_t ovf;
+    int32_t samples = 256;
+
+    if (argc > 1 && (!msh_arg_to_int(argv[1], &samples) || samples < 1 || samples > 10000))
+    {
+        bsp_printf("Usage: isr [samples 1..10000]\r\n");
+        return -1;
+    }
+    uart_tx_flush(UART_CONSOLE_PORT); // 串口发送中断会计入测量结果
+    sys_timer_measure_isr(&tick, &ovf, (uint16_t)samples);
+    msh_isr_report("tick", &tick);
+    msh_isr_report("tim3 ovf", &ovf);
+    return 0;
+}
+
+#if MSH_PRINTF_BENCH
+#define MSH_PRINTF_BENCH_RUNS   100
+
+// 格式化测试用例：同一格式和参数分别交给bsp_snprintf和工具链sprintf
+static int msh_fmt_case(uint8_t index, bool lib, char *buf, uint16_t size)
+{
+    switch (index)
+    {
+    case 0:
+        return lib ? sprintf(buf, "%lu", 4000000000UL) : bsp_snprintf(buf, size, "%lu", 4000000000UL);
+    case 1:
+        return lib ? sprintf(buf, "%x", 0xBEEFU) : bsp_snprintf(buf, size, "%x", 0xBEEFU);
+    default:
+        return lib ? sprintf(buf, "%5u %08lX", 1234U, 0xCAFEUL) : bsp_snprintf(buf, size, "%5u %08lX", 1234U, 0xCAFEUL);
+    }
+}
+
+// fmtbench命令：以TIM3周期计数对比bsp_snprintf与工具链sprintf每次格式化的平均周期数（含期间的中断）
+int msh_cmd_fmtbench(int argc, char **argv)
+{
+    static const char *const names[] = {"%lu", "%x", "%5u %08lX"};
+    char buf[2][24];
+    uint32_t cycles[2];
+    uint32_t start;
+    uint8_t i;
+    uint8_t lib;
+    uint8_t n;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        for (lib = 0; lib < 2; lib++)
+        {
+            start = sys_timer_get_cycles();
+            for (n = 0; n < MSH_PRINTF_BENCH_RUNS; n++)
+            {
+                msh_fmt_case(i, (bool)lib, buf[lib], sizeof(buf[lib]));
+            }
+            cycles[lib] = (sys_timer_get_cycles() - start) / MSH_PRINTF_BENCH_RUNS;
+        }
+        bsp_printf("%-10s bsp %5lu cycles, sprintf %5lu cycles%s\r\n", names[i], cycles[0], cycles[1],
+                   strcmp(buf[0], buf[1]) == 0 ? "" : " (output differs)");
+    }
+    return 0;
+}
+#endif
+
+// clk命令：显示/切换时钟模式
+int msh_cmd_clk(int argc, char **argv)
+{
+    static const char *const names[BSP_CLK_MODE_NUM] = {"hse24", "hsi16", "hsi8", "hsi2", "cpu2"};
+    bsp_clk_mode_t mode = bsp_clk_get_mode();
+    bsp_clk_stats_t stats;
+    uint8_t i;
+
+    if (argc < 2)
+    {
+        bsp_clk_get_stats(&stats);
+        bsp_printf("mode %s, fmaster %lu Hz, fcpu %lu Hz\r\n", mode < BSP_CLK_MODE_NUM ? names[mode] : "custom",
+                   CLK_GetClockFreq(), bsp_clk_get_fcpu());
+        bsp_printf("HSE start fail %u, CSS failover %u (last at %lu ms)\r\n", stats.hse_start_fail,
+                   stats.css_failover, stats.last_failover_ms);
+        return 0;
+    }
+    for (i = 0; i < BSP_CLK_MODE_NUM; i++)
+    {
+        if (strcmp(argv[1], names[i]) == 0)
+        {
+            break;
+        }
+    }
+    if (i >= BSP_CLK_MODE_NUM)
+    {
+        bsp_printf("Usage: clk [hse24|hsi16|hsi8|hsi2|cpu2]\r\n");
+        return -1;
+    }
+    if (!bsp_clk_set_mode((bsp_clk_mode_t)i))
+    {
+        bsp_printf("Clock switch failed\r\n");
+        return -1;
+    }
+    return 0;
+}
+
+// clocks命令：列出外设时钟的引用计数和开关状态
+int msh_cmd_clocks(int argc, char **argv)
+{
+    static const struct
+    {
+        const char *name;
+        CLK_Peripheral_TypeDef peripheral;
+    } periphs[] = {
+        {"I2C", CLK_PERIPHERAL_I2C},
+        {"SPI", CLK_PERIPHERAL_SPI},
+        {"UART1", CLK_PERIPHERAL_UART1},
+        {"UART3", CLK_PERIPHERAL_UART3},
+        {"TIM4", CLK_PERIPHERAL_TIMER4},
+        {"TIM2", CLK_PERIPHERAL_TIMER2},
+        {"TIM3", CLK_PERIPHERAL_TIMER3},
+        {"TIM1", CLK_PERIPHERAL_TIMER1},
+        {"AWU", CLK_PERIPHERAL_AWU},
+        {"ADC", CLK_PERIPHERAL_ADC},
+    };
+    uint8_t pckenr;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(periphs) / sizeof(periphs[0]); i++)
+    {
+        // 编号0x1x对应PCKENR2，低3位为位号
+        pckenr = (periphs[i].peripheral & 0x10) ? CLK->PCKENR2 : CLK->PCKENR1;
+        bsp_printf("%-6s %s refs %u\r\n", periphs[i].name,
+                   (pckenr & (1 << (periphs[i].peripheral & 0x07))) ? "on " : "off",
+                   bsp_clk_refcount(periphs[i].peripheral));
+    }
+    return 0;
+}
+
+// pwr命令：显示各低功耗模式的驻留统计，或设置允许的最深模式
+int msh_cmd_pwr(int argc, char **argv)
+{
+    static const char *const names[BSP_PWR_MODE_NUM] = {"run", "wait", "ahalt", "halt"};
+    bsp_pwr_stats_t stats;
+    uint32_t uptime;
+    uint8_t i;
+
+    if (argc < 2)
+    {
+        bsp_pwr_get_stats(&stats);
+        uptime = sys_timer_get_system_time_ms();
+        bsp_printf("max mode %s, LSI %lu Hz, early wake %u\r\n", names[bsp_pwr_get_max_mode()],
+                   stats.lsi_hz, stats.early_wake);
+        for (i = 0; i < BSP_PWR_MODE_NUM; i++)
+        {
+            bsp_printf("%-6s %10lu times %10lu ms %3lu%%\r\n", names[i], stats.count[i], stats.time_ms[i],
+                       uptime == 0 ? 0 : stats.time_ms[i] / (uptime / 100 + 1));
+        }
+        return 0;
+    }
+    for (i = 0; i < BSP_PWR_MODE_NUM; i++)
+    {
+        if (strcmp(argv[1], names[i]) == 0)
+        {
+            bsp_pwr_set_max_mode((bsp_pwr_mode_t)i);
+            return 0;
+        }
+    }
+    bsp_printf("Usage: pwr [run|wait|ahalt|halt]\r\n");
+    return -1;
+}
+
+// boot命令：显示各启动阶段的时间戳和耗时（微秒，从TIM4启动开始计）
+int msh_cmd_boot(int argc, char **argv)
+{
+    const bsp_boot_mark_t *mark;
+    uint32_t last = 0;
+    uint8_t i;
+
+    bsp_printf("fast boot %s\r\n", BSP_FAST_BOOT ? "on" : "off");
+    for (i = 0; (mark = bsp_boot_get(i)) != NULL; i++)
+    {
+        bsp_printf("%-10s %10lu us  +%lu\r\n", mark->name, mark->us, mark->us - last);
+        last = mark->us;
+    }
+    return 0;
+}
+
+#if MSH_SESSION_NUM > 1
+// 会话1使用UART3
+static void msh_uart3_write(const uint8_t *data, uint16_t len)
+{
+    uart_write(UART_PORT_3, data, len);
+}
+
+static uint8_t msh_uart3_read(uint8_t *buf, uint8_t len)
+{
+    return uart_read(UART_PORT_3, buf, len);
+}
+#endif
+
 const msh_cmd_t msh_list[] =
     {
         MSH_CMD_DEF(echo, "Echo input string", msh_cmd_echo),
         MSH_CMD_DEF(help, "List all commands", msh_cmd_help),
         MSH_CMD_DEF(clear, "Clear screen", msh_cmd_clear),
+        MSH_CMD_DEF(ps, "List tasks", msh_cmd_ps),
+        MSH_CMD_DEF(rpc, "Enter binary RPC mode", msh_cmd_rpc),
+        MSH_CMD_DEF(repeat, "Run command N times in background", msh_cmd_repeat),
+        MSH_CMD_DEF(every, "Run command periodically in background", msh_cmd_every),
+        MSH_CMD_DEF(jobs, "List background jobs", msh_cmd_jobs),
+        MSH_CMD_DEF(stop, "Stop background jobs", msh_cmd_stop),
+        MSH_CMD_DEF_ARGS(script, "Manage EEPROM scripts", msh_cmd_script, msh_script_args),
+        MSH_CMD_DEF(run, "Run EEPROM script", msh_cmd_run),
+        MSH_CMD_DEF(md, "Dump memory in hex", msh_cmd_md),
+        MSH_CMD_DEF_ARGS(mw, "Write memory/register bytes", msh_cmd_mw, msh_mem_write_args),
+        MSH_CMD_DEF(regs, "Show peripheral registers", msh_cmd_regs),
+        MSH_CMD_DEF(uart, "Show UART statistics", msh_cmd_uart),
+        MSH_CMD_DEF(baud, "Show/set console baud rate", msh_cmd_baud),
+        MSH_CMD_DEF(delay, "Measure delay_us/delay_ms accuracy", msh_cmd_delay),
+        MSH_CMD_DEF(isr, "Measure timer ISR cycles", msh_cmd_isr),
+#if MSH_PRINTF_BENCH
+        MSH_CMD_DEF(fmtbench, "Compare bsp_snprintf with sprintf", msh_cmd_fmtbench),
+#endif
+        MSH_CMD_DEF(clk, "Show/switch clock mode", msh_cmd_clk),
+        MSH_CMD_DEF(clocks, "List peripheral clocks", msh_cmd_clocks),
+        MSH_CMD_DEF(pwr, "Show low-power residency/set max mode", msh_cmd_pwr),
+        MSH_CMD_DEF(boot, "Show boot phase timing", msh_cmd_boot),
 };
 
 void msh_cmd_init()
@@ -20,6 +373,30 @@ void msh_cmd_init()
 void msh_task_init(void)
 {
     msh_init();
+#if MSH_SESSION_NUM > 1
+    {
+        uart_config_t config = {MSH_UART3_BAUDRATE, UART_WORDLENGTH_8D, UART_PARITY_NO, UART_STOPBITS_1};
+
+        uart_init(UART_PORT_3, &config);
+        msh_session_init(1, msh_uart3_write, msh_uart3_read);
+    }
+#endif
     mtos_task_create("msh_task", msh_process, msh_cmd_init, 10);
-    uart_set_rx_callback(msh_rx_input);
+    mtos_task_create(MSH_JOB_TASK_NAME, msh_job_process, NULL, 1);
+    mtos_task_create("msh_stream", msh_stream_process, NULL, 0);
+#if !BSP_FAST_BOOT
+    msh_script_run(MSH_SCRIPT_BOOT_NAME); // 执行上电脚本（如果存在）
+#endif
+}
+
+// 快速启动时推迟的初始化：各会话的欢迎信息和上电脚本，在第一次调度时由后台任务调用
+void msh_task_boot_deferred(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MSH_SESSION_NUM; i++)
+    {
+        msh_banner(i);
+    }
+    msh_script_run(MSH_SCRIPT_BOOT_NAME);
 }
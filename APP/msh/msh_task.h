@@ -6,5 +6,6 @@
 #include "msh.h"
 
 void msh_task_init(void);
+void msh_task_boot_deferred(void);
 
 #endif
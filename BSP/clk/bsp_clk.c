@@ -1,4 +1,30 @@
-#include "bsp_clk.h"
+#include "bsp_sys_pub.h"
+#include "stm8s_flash.h"
+
+// 各模式的时钟源和分频
+typedef struct
+{
+    CLK_Source_TypeDef source;
+    CLK_Prescaler_TypeDef hsidiv;
+    CLK_Prescaler_TypeDef cpudiv;
+} bsp_clk_mode_cfg_t;
+
+static const bsp_clk_mode_cfg_t bsp_clk_modes[BSP_CLK_MODE_NUM] = {
+    {CLK_SOURCE_HSE, CLK_PRESCALER_HSIDIV1, CLK_PRESCALER_CPUDIV1},
+    {CLK_SOURCE_HSI, CLK_PRESCALER_HSIDIV1, CLK_PRESCALER_CPUDIV1},
+    {CLK_SOURCE_HSI, CLK_PRESCALER_HSIDIV2, CLK_PRESCALER_CPUDIV1},
+    {CLK_SOURCE_HSI, CLK_PRESCALER_HSIDIV8, CLK_PRESCALER_CPUDIV1},
+    {CLK_SOURCE_HSI, CLK_PRESCALER_HSIDIV1, CLK_PRESCALER_CPUDIV8},
+};
+
+static bsp_clk_notify_t bsp_clk_notifies[BSP_CLK_NOTIFY_MAX];
+static uint8_t bsp_clk_notify_num = 0;
+static bsp_clk_stats_t bsp_clk_stats;
+static volatile bool bsp_clk_failover_pending = FALSE; // 时钟安全系统已切换时钟，等待通知各模块
+
+// 外设时钟引用计数，PCKENR1各位对应下标0~7，PCKENR2对应8~15
+#define BSP_CLK_PERIPH_INDEX(p) ((uint8_t)(((p) & 0x07) | (((p) & 0x10) >> 1)))
+static uint8_t bsp_clk_refs[16];
 
 __weak void bsp_clk_config_init(void)
 {
@@ -9,13 +35,224 @@ __weak void bsp_clk_config_init(void)
 
     CLK_HSICmd(ENABLE); // 内部高频RC开
 
-    CLK_PeripheralClockConfig(CLK_PERIPHERAL_TIMER2, ENABLE); // Timer1
-    CLK_PeripheralClockConfig(CLK_PERIPHERAL_UART1, ENABLE);  // UART1
-    CLK_PeripheralClockConfig(CLK_PERIPHERAL_UART3, ENABLE);  // UART3
-    CLK_PeripheralClockConfig(CLK_PERIPHERAL_SPI, ENABLE);    // SPI
-    CLK_PeripheralClockConfig(CLK_PERIPHERAL_I2C, ENABLE);    // I2C
-    CLK_PeripheralClockConfig(CLK_PERIPHERAL_ADC, ENABLE);    // I2C
-    rim();                                                    // 打开总中断
+    // 复位后外设时钟全部打开，这里全部关闭，由各驱动通过bsp_clk_request按需打开
+    CLK->PCKENR1 = 0;
+    CLK->PCKENR2 &= (uint8_t)(~(CLK_PCKENR2_AWU | CLK_PCKENR2_ADC | CLK_PCKENR2_CAN));
+    rim(); // 打开总中断
+}
+
+// 注册时钟切换通知函数，已满时返回FALSE
+bool bsp_clk_notify_register(bsp_clk_notify_t notify)
+{
+    if (bsp_clk_notify_num >= BSP_CLK_NOTIFY_MAX)
+    {
+        return FALSE;
+    }
+    bsp_clk_notifies[bsp_clk_notify_num++] = notify;
+    return TRUE;
+}
+
+static void bsp_clk_notify_all(bsp_clk_event_t event, uint32_t fmaster)
+{
+    uint8_t i;
+
+    for (i = 0; i < bsp_clk_notify_num; i++)
+    {
+        bsp_clk_notifies[i](event, fmaster);
+    }
+}
+
+// 主时钟高于16MHz时Flash需要1个等待周期（OPT7=1），选项字节读取出错时按未设置处理
+static bool bsp_clk_waitstate_ok(void)
+{
+    uint16_t option = FLASH_ReadOptionByte(BSP_CLK_OPT_WAITSTATE);
+
+    if (option == FLASH_OPTIONBYTE_ERROR)
+    {
+        return FALSE;
+    }
+    return (option & 0x0100) ? TRUE : FALSE;
+}
+
+// 开启HSE并等待起振，超时时关闭HSE
+static bool bsp_clk_hse_start(void)
+{
+    uint16_t n = BSP_CLK_HSE_TIMEOUT;
+
+    CLK_HSECmd(ENABLE);
+    while (!(CLK->ECKR & CLK_ECKR_HSERDY))
+    {
+        if (--n == 0)
+        {
+            CLK_HSECmd(DISABLE);
+            bsp_clk_stats.hse_start_fail++;
+            BSP_LOG0(CLK_HSE_TIMEOUT);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+// 自动切换时钟源，失败时取消切换并关闭未使用的HSE
+static bool bsp_clk_switch(CLK_Source_TypeDef source)
+{
+    if (CLK_ClockSwitchConfig(CLK_SWITCHMODE_AUTO, source, DISABLE, CLK_CURRENTCLOCKSTATE_DISABLE) == SUCCESS)
+    {
+        return TRUE;
+    }
+    CLK_ClockSwitchCmd(DISABLE);
+    if (source == CLK_SOURCE_HSE)
+    {
+        CLK_HSECmd(DISABLE);
+    }
+    return FALSE;
+}
+
+// 切换时钟模式，切换前后按注册顺序通知各模块。HSE起振失败或选项字节不允许时返回FALSE，时钟保持不变。
+// 切换到HSE后开启时钟安全系统（开启后直到复位都不能关闭），HSE失效时由中断切换回HSI
+bool bsp_clk_set_mode(bsp_clk_mode_t mode)
+{
+    const bsp_clk_mode_cfg_t *cfg;
+    bool ok = TRUE;
+
+    if (mode >= BSP_CLK_MODE_NUM)
+    {
+        return FALSE;
+    }
+    if (mode == bsp_clk_get_mode())
+    {
+        return TRUE;
+    }
+    cfg = &bsp_clk_modes[mode];
+    if (cfg->source == CLK_SOURCE_HSE)
+    {
+        if ((HSE_VALUE > 16000000UL && !bsp_clk_waitstate_ok()) || !bsp_clk_hse_start())
+        {
+            return FALSE;
+        }
+    }
+
+    bsp_clk_notify_all(BSP_CLK_EVT_PRE, CLK_GetClockFreq());
+    CLK_SYSCLKConfig(cfg->cpudiv);
+    if (cfg->source == CLK_SOURCE_HSI)
+    {
+        // 当前为HSE时HSI分频在切换完成后生效
+        CLK_SYSCLKConfig(cfg->hsidiv);
+        if (CLK_GetSYSCLKSource() != CLK_SOURCE_HSI)
+        {
+            ok = bsp_clk_switch(CLK_SOURCE_HSI);
+        }
+    }
+    else
+    {
+        ok = bsp_clk_switch(CLK_SOURCE_HSE);
+        if (ok)
+        {
+            CLK_ClockSecuritySystemEnable();
+            CLK_ITConfig(CLK_IT_CSSD, ENABLE);
+        }
+    }
+    // 切换失败时时钟源不变，但CPU分频可能已修改，仍然通知各模块按实际频率重新配置
+    bsp_clk_notify_all(BSP_CLK_EVT_POST, CLK_GetClockFreq());
+    BSP_LOG2(CLK_MODE, bsp_clk_get_mode(), CLK_GetClockFreq());
+    return ok;
+}
+
+// 按寄存器判断当前模式，不属于任何模式时返回BSP_CLK_MODE_NUM
+bsp_clk_mode_t bsp_clk_get_mode(void)
+{
+    CLK_Source_TypeDef source = CLK_GetSYSCLKSource();
+    uint8_t ckdivr = CLK->CKDIVR;
+    uint8_t i;
+
+    for (i = 0; i < BSP_CLK_MODE_NUM; i++)
+    {
+        if (bsp_clk_modes[i].source == source &&
+            (source == CLK_SOURCE_HSE || (ckdivr & CLK_CKDIVR_HSIDIV) == (bsp_clk_modes[i].hsidiv & CLK_CKDIVR_HSIDIV)) &&
+            (ckdivr & CLK_CKDIVR_CPUDIV) == (bsp_clk_modes[i].cpudiv & CLK_CKDIVR_CPUDIV))
+        {
+            return (bsp_clk_mode_t)i;
+        }
+    }
+    return BSP_CLK_MODE_NUM;
+}
+
+// CPU时钟 = fmaster / 2^CPUDIV
+uint32_t bsp_clk_get_fcpu(void)
+{
+    return CLK_GetClockFreq() >> (CLK->CKDIVR & CLK_CKDIVR_CPUDIV);
+}
+
+// 申请外设时钟，第一次申请时打开
+void bsp_clk_request(CLK_Peripheral_TypeDef peripheral)
+{
+    uint8_t index = BSP_CLK_PERIPH_INDEX(peripheral);
+    __istate_t istate = __get_interrupt_state();
+
+    __disable_interrupt();
+    if (bsp_clk_refs[index]++ == 0)
+    {
+        CLK_PeripheralClockConfig(peripheral, ENABLE);
+    }
+    __set_interrupt_state(istate);
+}
+
+// 释放外设时钟，最后一个使用者释放时关闭
+void bsp_clk_release(CLK_Peripheral_TypeDef peripheral)
+{
+    uint8_t index = BSP_CLK_PERIPH_INDEX(peripheral);
+    __istate_t istate = __get_interrupt_state();
+
+    __disable_interrupt();
+    if (bsp_clk_refs[index] != 0 && --bsp_clk_refs[index] == 0)
+    {
+        CLK_PeripheralClockConfig(peripheral, DISABLE);
+    }
+    __set_interrupt_state(istate);
+}
+
+uint8_t bsp_clk_refcount(CLK_Peripheral_TypeDef peripheral)
+{
+    return bsp_clk_refs[BSP_CLK_PERIPH_INDEX(peripheral)];
+}
+
+void bsp_clk_get_stats(bsp_clk_stats_t *stats)
+{
+    __istate_t istate = __get_interrupt_state();
+
+    __disable_interrupt();
+    *stats = bsp_clk_stats;
+    __set_interrupt_state(istate);
+}
+
+// 时钟安全系统失效切换后的处理任务：按新主时钟通知各模块（定时器、延时、串口波特率）。
+// 切换时正在发送的串口数据已经按错误的波特率发出，不再等待，只发送POST通知
+void bsp_clk_process(void)
+{
+    uint32_t fmaster;
+
+    if (!bsp_clk_failover_pending)
+    {
+        return;
+    }
+    bsp_clk_failover_pending = FALSE;
+    fmaster = CLK_GetClockFreq();
+    bsp_clk_notify_all(BSP_CLK_EVT_POST, fmaster);
+    BSP_LOG1(CLK_CSS_FAILOVER, fmaster);
+}
+
+// 时钟安全系统中断：HSE失效时硬件已切换到HSI/8并关闭HSE，这里恢复HSI不分频（与上电时钟相同），
+// 其余模块的重新配置在bsp_clk_process中完成（需要重新校准延时，不适合在中断中执行）
+INTERRUPT_HANDLER(CLK_IRQHandler, 2)
+{
+    if (CLK->CSSR & CLK_CSSR_CSSD)
+    {
+        CLK->CSSR &= (uint8_t)(~CLK_CSSR_CSSD);
+        CLK->CKDIVR &= (uint8_t)(~CLK_CKDIVR_HSIDIV);
+        bsp_clk_stats.css_failover++;
+        bsp_clk_stats.last_failover_ms = sys_timer_get_system_time_ms();
+        bsp_clk_failover_pending = TRUE;
+    }
 }
 
 // void bsp_clk_config_init(void)
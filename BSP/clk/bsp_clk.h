@@ -3,6 +3,51 @@
 
 #include "stm8s_clk.h"
 
+// 时钟模式，fmaster为外设时钟，fcpu为CPU时钟
+typedef enum
+{
+    BSP_CLK_MODE_HSE_24M = 0,   // HSE 24MHz，需要选项字节OPT7（Flash等待周期）为1
+    BSP_CLK_MODE_HSI_16M,       // HSI 16MHz，上电默认
+    BSP_CLK_MODE_HSI_8M,        // HSI/2
+    BSP_CLK_MODE_HSI_2M,        // HSI/8
+    BSP_CLK_MODE_HSI_16M_CPU_2M,// 外设16MHz，CPU/8，外设定时不变
+    BSP_CLK_MODE_NUM,
+} bsp_clk_mode_t;
+
+#define BSP_CLK_NOTIFY_MAX      4       // 可注册的时钟切换通知函数数量
+#define BSP_CLK_OPT_WAITSTATE   0x480D  // 选项字节OPT7地址，主时钟高于16MHz时须为1
+#define BSP_CLK_HSE_TIMEOUT     0xFFFF  // 等待HSE起振的查询次数（16MHz下约30ms）
+#define BSP_CLK_BOOT_MODE       BSP_CLK_MODE_HSI_16M // 启动时切换的模式，HSE起振失败时保持HSI 16MHz
+
+// 时钟切换事件
+typedef enum
+{
+    BSP_CLK_EVT_PRE = 0,    // 即将切换（如等待串口发送完成），fmaster为切换前的频率
+    BSP_CLK_EVT_POST,       // 切换完成（重新计算分频值等），fmaster为切换后的频率
+} bsp_clk_event_t;
+
+// 时钟切换通知函数，按注册顺序调用
+typedef void (*bsp_clk_notify_t)(bsp_clk_event_t event, uint32_t fmaster);
+
+// 时钟源状态统计
+typedef struct
+{
+    uint16_t hse_start_fail;    // HSE起振超时次数
+    uint16_t css_failover;      // 时钟安全系统检测到HSE失效、切换到HSI的次数
+    uint32_t last_failover_ms;  // 最近一次失效的时间
+} bsp_clk_stats_t;
+
 void bsp_clk_config_init(void);
+void bsp_clk_process(void);
+bool bsp_clk_notify_register(bsp_clk_notify_t notify);
+bool bsp_clk_set_mode(bsp_clk_mode_t mode);
+bsp_clk_mode_t bsp_clk_get_mode(void);
+uint32_t bsp_clk_get_fcpu(void);
+void bsp_clk_get_stats(bsp_clk_stats_t *stats);
+
+// 外设时钟引用计数：驱动打开时申请、关闭时释放，计数为0的外设时钟关闭
+void bsp_clk_request(CLK_Peripheral_TypeDef peripheral);
+void bsp_clk_release(CLK_Peripheral_TypeDef peripheral);
+uint8_t bsp_clk_refcount(CLK_Peripheral_TypeDef peripheral);
 
 #endif
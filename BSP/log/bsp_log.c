@@ -0,0 +1,117 @@
+#include "bsp_sys_pub.h"
+
+#define BSP_LOG_BUF_MASK (BSP_LOG_BUF_SIZE - 1)
+
+// 日志编号只占1字节
+typedef char bsp_log_id_check[(BSP_LOG_ID_NUM <= 256) ? 1 : -1];
+
+// 环形缓冲区中保存完整记录，head由写入方在关中断时修改，tail只由发送任务修改
+static uint8_t bsp_log_buf[BSP_LOG_BUF_SIZE];
+static volatile uint8_t bsp_log_head = 0;
+static volatile uint8_t bsp_log_tail = 0;
+static volatile uint16_t bsp_log_dropped = 0; // 缓冲区满丢弃的记录数，发送任务补发LOG_DROPPED后清零
+static bool bsp_log_held = FALSE;
+
+// 按小端写入32位值
+static uint8_t *bsp_log_put32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+// 写入一条日志记录，缓冲区空间不足时丢弃并计数
+void bsp_log_write(uint8_t id, uint8_t argc, uint32_t a, uint32_t b, uint32_t c)
+{
+    uint8_t record[BSP_LOG_HEAD_SIZE + BSP_LOG_ARGS_MAX * 4];
+    uint8_t *p = record;
+    uint8_t size;
+    uint8_t head;
+    uint8_t i;
+    __istate_t istate;
+
+    *p++ = BSP_LOG_SYNC;
+    *p++ = id;
+    *p++ = (uint8_t)(argc * 4);
+    p = bsp_log_put32(p, sys_timer_get_system_time_ms());
+    if (argc > 0)
+    {
+        p = bsp_log_put32(p, a);
+    }
+    if (argc > 1)
+    {
+        p = bsp_log_put32(p, b);
+    }
+    if (argc > 2)
+    {
+        p = bsp_log_put32(p, c);
+    }
+    size = (uint8_t)(p - record);
+
+    // 中断和任务都可能写入，预留空间和复制需要关中断（最长19字节）
+    istate = __get_interrupt_state();
+    __disable_interrupt();
+    head = bsp_log_head;
+    if ((uint8_t)(BSP_LOG_BUF_MASK - ((head - bsp_log_tail) & BSP_LOG_BUF_MASK)) < size)
+    {
+        bsp_log_dropped++;
+    }
+    else
+    {
+        for (i = 0; i < size; i++)
+        {
+            bsp_log_buf[head] = record[i];
+            head = (head + 1) & BSP_LOG_BUF_MASK;
+        }
+        bsp_log_head = head;
+    }
+    __set_interrupt_state(istate);
+}
+
+// 发送任务：只发送完整记录，避免与其他任务的文本输出交错在记录内部
+void bsp_log_process(void)
+{
+    uint8_t tail = bsp_log_tail;
+    uint8_t size;
+    uint8_t first;
+    uint16_t dropped;
+
+    if (bsp_log_held)
+    {
+        return;
+    }
+    if (bsp_log_dropped != 0 && tail == bsp_log_head)
+    {
+        dropped = bsp_log_dropped;
+        bsp_log_dropped = 0; // 与写入方的计数竞争时最多少记一次
+        BSP_LOG1(LOG_DROPPED, dropped);
+    }
+    while (tail != bsp_log_head)
+    {
+        size = BSP_LOG_HEAD_SIZE + bsp_log_buf[(tail + 2) & BSP_LOG_BUF_MASK];
+        if (uart_tx_free(UART_CONSOLE_PORT) < size)
+        {
+            break;
+        }
+        first = BSP_LOG_BUF_SIZE - tail;
+        if (first >= size)
+        {
+            uart_write(UART_CONSOLE_PORT, &bsp_log_buf[tail], size);
+        }
+        else
+        {
+            uart_write(UART_CONSOLE_PORT, &bsp_log_buf[tail], first);
+            uart_write(UART_CONSOLE_PORT, bsp_log_buf, size - first);
+        }
+        tail = (tail + size) & BSP_LOG_BUF_MASK;
+        bsp_log_tail = tail;
+    }
+}
+
+// 暂停/恢复发送
+void bsp_log_hold(bool hold)
+{
+    bsp_log_held = hold;
+}
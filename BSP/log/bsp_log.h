@@ -0,0 +1,76 @@
+#ifndef __BSP_LOG_H__
+#define __BSP_LOG_H__
+
+#include "stm8s.h"
+#include "bsp_log_def.h"
+
+/*
+ * 二进制日志：设备端只记录日志编号、时间戳和原始参数，写入环形缓冲区后立即返回，
+ * 由后台任务（bsp_log_process）在控制台发送缓冲区有空间时整条发出，主机端按bsp_log_def.h解码为文本
+ *
+ * 记录格式：SYNC(0xA7) ID LEN TIME(4) ARGS(LEN)
+ * TIME   系统毫秒时间，低字节在前
+ * ARGS   每个参数4字节，低字节在前，LEN为参数个数*4
+ *
+ * 控制台文本输出均为ASCII，解码时以SYNC区分日志记录与文本
+ */
+
+#define BSP_LOG_SYNC            0xA7
+#define BSP_LOG_BUF_SIZE        128   // 环形缓冲区大小，必须为2的幂且不超过256
+#define BSP_LOG_ARGS_MAX        3     // 单条记录最多参数个数
+#define BSP_LOG_HEAD_SIZE       7     // SYNC ID LEN TIME
+
+#if (BSP_LOG_BUF_SIZE & (BSP_LOG_BUF_SIZE - 1)) != 0 || BSP_LOG_BUF_SIZE > 256
+#error "BSP_LOG_BUF_SIZE must be a power of two not larger than 256"
+#endif
+
+// 日志级别
+#define BSP_LOG_DEBUG           0
+#define BSP_LOG_INFO            1
+#define BSP_LOG_WARN            2
+#define BSP_LOG_ERROR           3
+#define BSP_LOG_NONE            4     // 用于关闭模块的全部日志
+
+// 各模块输出的最低级别，低于该级别的日志调用在编译期被去除
+#define BSP_LOG_LEVEL_LOG       BSP_LOG_INFO
+#define BSP_LOG_LEVEL_SYS       BSP_LOG_INFO
+#define BSP_LOG_LEVEL_UART      BSP_LOG_INFO
+#define BSP_LOG_LEVEL_CLK       BSP_LOG_INFO
+#define BSP_LOG_LEVEL_PWR       BSP_LOG_INFO
+
+// 日志编号
+typedef enum
+{
+#define BSP_LOG_ENUM_ID(id, mod, lvl, fmt) BSP_LOG_ID_##id,
+    BSP_LOG_TABLE(BSP_LOG_ENUM_ID)
+#undef BSP_LOG_ENUM_ID
+    BSP_LOG_ID_NUM
+} bsp_log_id_t;
+
+// 各日志是否编译进固件
+enum
+{
+#define BSP_LOG_ENUM_ON(id, mod, lvl, fmt) BSP_LOG_ON_##id = (BSP_LOG_##lvl >= BSP_LOG_LEVEL_##mod),
+    BSP_LOG_TABLE(BSP_LOG_ENUM_ON)
+#undef BSP_LOG_ENUM_ON
+};
+
+// 记录日志，可在中断中调用。id为bsp_log_def.h中的名称（不带前缀）
+#define BSP_LOG0(id) \
+    do { if (BSP_LOG_ON_##id) bsp_log_write(BSP_LOG_ID_##id, 0, 0, 0, 0); } while (0)
+#define BSP_LOG1(id, a) \
+    do { if (BSP_LOG_ON_##id) bsp_log_write(BSP_LOG_ID_##id, 1, (uint32_t)(a), 0, 0); } while (0)
+#define BSP_LOG2(id, a, b) \
+    do { if (BSP_LOG_ON_##id) bsp_log_write(BSP_LOG_ID_##id, 2, (uint32_t)(a), (uint32_t)(b), 0); } while (0)
+#define BSP_LOG3(id, a, b, c) \
+    do { if (BSP_LOG_ON_##id) bsp_log_write(BSP_LOG_ID_##id, 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c)); } while (0)
+
+void bsp_log_write(uint8_t id, uint8_t argc, uint32_t a, uint32_t b, uint32_t c);
+
+// 后台发送任务，每次调度发出缓冲区中能放入控制台发送缓冲区的完整记录
+void bsp_log_process(void);
+
+// 暂停/恢复发送（如二进制RPC模式期间），暂停时记录继续缓存，满后丢弃
+void bsp_log_hold(bool hold);
+
+#endif
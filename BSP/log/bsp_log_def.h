@@ -0,0 +1,22 @@
+#ifndef __BSP_LOG_DEF_H__
+#define __BSP_LOG_DEF_H__
+
+/*
+ * 日志定义表：X(名称, 模块, 级别, 格式)
+ *
+ * 格式字符串只供主机端解码（Tools/bsp_log_decode.py解析本文件），设备端不引用，不占用Flash。
+ * 每个参数在记录中固定为4字节，格式中按bsp_printf的写法使用%lu/%ld/%lx
+ * 新增日志追加在末尾，不要删除或调整已有条目的顺序（编号即下标，旧日志数据依赖它解码）
+ * 解码脚本按行解析，每个条目必须写在一行内
+ */
+
+#define BSP_LOG_TABLE(X) \
+    X(LOG_DROPPED, LOG, WARN, "%lu log records dropped") \
+    X(SYS_BOOT, SYS, INFO, "boot, reset flags 0x%02lx") \
+    X(UART_AUTOBAUD, UART, INFO, "uart port %lu autobaud, divider %lu") \
+    X(CLK_MODE, CLK, INFO, "clock mode %lu, fmaster %lu Hz") \
+    X(CLK_HSE_TIMEOUT, CLK, ERROR, "HSE start timeout") \
+    X(CLK_CSS_FAILOVER, CLK, ERROR, "HSE failure, switched to HSI, fmaster %lu Hz") \
+    X(PWR_LSI, PWR, INFO, "LSI %lu Hz, AWU unit %lu ns")
+
+#endif
@@ -0,0 +1,242 @@
+#include "bsp_sys_pub.h"
+#include "stm8s_awu.h"
+#include "stm8s_flash.h"
+
+#define BSP_PWR_AWU_TB_MAX      12      // AWUTB 1~12的时基为2^(AWUTB-1)个最小时基，最长约512ms
+#define BSP_PWR_LSI_TIMEOUT     0xFFFF  // 等待LSI就绪和捕获的查询次数
+
+static bsp_pwr_hook_t bsp_pwr_hooks[BSP_PWR_HOOK_MAX];
+static uint8_t bsp_pwr_hook_num = 0;
+static bsp_pwr_mode_t bsp_pwr_mode_max = BSP_PWR_MODE_MAX;
+static bsp_pwr_stats_t bsp_pwr_stats;
+static uint16_t bsp_pwr_time_us[BSP_PWR_MODE_NUM]; // 不足1ms的驻留时间
+static uint32_t bsp_pwr_awu_unit_ns = 250000;      // AWU最小时基（AWUTB=1）的实际长度
+static volatile bool bsp_pwr_awu_fired = FALSE;
+
+// 注册低功耗钩子，已满时返回FALSE
+bool bsp_pwr_hook_register(bsp_pwr_hook_t hook)
+{
+    if (bsp_pwr_hook_num >= BSP_PWR_HOOK_MAX)
+    {
+        return FALSE;
+    }
+    bsp_pwr_hooks[bsp_pwr_hook_num++] = hook;
+    return TRUE;
+}
+
+// 任一模块正在工作时返回TRUE
+static bool bsp_pwr_busy(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < bsp_pwr_hook_num; i++)
+    {
+        if (bsp_pwr_hooks[i](BSP_PWR_EVT_CHECK))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void bsp_pwr_notify_all(bsp_pwr_event_t event)
+{
+    uint8_t i;
+
+    for (i = 0; i < bsp_pwr_hook_num; i++)
+    {
+        (void)bsp_pwr_hooks[i](event);
+    }
+}
+
+// 累计驻留次数和时间
+static void bsp_pwr_account(bsp_pwr_mode_t mode, uint32_t us)
+{
+    uint32_t total = us + bsp_pwr_time_us[mode];
+
+    bsp_pwr_stats.count[mode]++;
+    bsp_pwr_stats.time_ms[mode] += total / 1000;
+    bsp_pwr_time_us[mode] = (uint16_t)(total % 1000);
+}
+
+// 测量LSI频率：AWU_CSR.MSR把LSI连接到TIM3输入捕获1（STM8S20x），每8个LSI周期捕获一次，
+// 两次捕获的差值为8个LSI周期的主时钟计数。TIM3由系统定时器以主时钟自由运行（高分辨率时间），
+// 这里只使用捕获通道，不修改计数器。测量失败或超出LSI范围时返回典型值
+static uint32_t bsp_pwr_measure_lsi(void)
+{
+    uint16_t stamp[2];
+    uint16_t span;
+    uint16_t n;
+    uint8_t high;
+    uint8_t i;
+    uint32_t lsi;
+
+    bsp_clk_request(CLK_PERIPHERAL_TIMER3);
+    AWU->CSR |= AWU_CSR_MSR;
+    TIM3->CCMR1 = TIM3_CCMR_ICxPSC | 0x01; // CC1S=01，IC1映射到TI1；IC1PSC=11，8分频
+    TIM3->CCER1 = TIM3_CCER1_CC1E;
+    TIM3->SR1 = (uint8_t)(~TIM3_SR1_CC1IF); // 只清除捕获标志，UIF由溢出中断处理
+    for (i = 0; i < 2; i++)
+    {
+        n = BSP_PWR_LSI_TIMEOUT;
+        while (!(TIM3->SR1 & TIM3_SR1_CC1IF) && --n)
+            ;
+        if (n == 0)
+        {
+            break;
+        }
+        high = TIM3->CCR1H; // 先读高字节，读低字节时清除CC1IF
+        stamp[i] = ((uint16_t)high << 8) | TIM3->CCR1L;
+    }
+    TIM3->CCER1 = 0;
+    TIM3->CCMR1 = 0;
+    AWU->CSR &= (uint8_t)(~AWU_CSR_MSR);
+    bsp_clk_release(CLK_PERIPHERAL_TIMER3);
+
+    span = stamp[1] - stamp[0];
+    if (i < 2 || span == 0)
+    {
+        return LSI_VALUE;
+    }
+    lsi = CLK_GetClockFreq() * 8 / span;
+    return (lsi < LSI_FREQUENCY_MIN || lsi > LSI_FREQUENCY_MAX) ? LSI_VALUE : lsi;
+}
+
+// 开启LSI并按实测频率校准AWU，LSI无法启动时最深只使用WAIT
+void bsp_pwr_init(void)
+{
+    uint16_t n = BSP_PWR_LSI_TIMEOUT;
+    uint32_t lsi;
+
+    CLK_LSICmd(ENABLE);
+    while (!(CLK->ICKR & CLK_ICKR_LSIRDY))
+    {
+        if (--n == 0)
+        {
+            bsp_pwr_mode_max = BSP_PWR_MODE_WAIT;
+            return;
+        }
+    }
+    bsp_clk_request(CLK_PERIPHERAL_AWU);
+    lsi = bsp_pwr_measure_lsi();
+    AWU_LSICalibrationConfig(lsi);
+    bsp_pwr_stats.lsi_hz = lsi;
+    bsp_pwr_awu_unit_ns = (uint32_t)((AWU->APR & AWU_APR_APR) + 2) * (1000000000UL / lsi);
+
+    FLASH_SetLowPowerMode(FLASH_LPMODE_POWERDOWN); // 停机时Flash掉电
+    CLK_SlowActiveHaltWakeUpCmd(ENABLE);           // 主动停机时关闭主电压调节器
+    BSP_LOG2(PWR_LSI, lsi, bsp_pwr_awu_unit_ns);
+}
+
+// 选择不超过ticks的最长AWU时基，不足BSP_PWR_AHALT_MIN_US时返回0
+static uint8_t bsp_pwr_awu_select(uint32_t ticks, uint32_t *sleep_us)
+{
+    uint32_t limit = ticks > SYS_MS_TO_TICKS(1000) ? 1000000UL : ticks * SYS_TICK_US;
+    uint32_t us;
+    uint8_t tb;
+
+    for (tb = BSP_PWR_AWU_TB_MAX; tb > 0; tb--)
+    {
+        us = (bsp_pwr_awu_unit_ns << (tb - 1)) / 1000;
+        if (us <= limit)
+        {
+            *sleep_us = us;
+            return us >= BSP_PWR_AHALT_MIN_US ? tb : 0;
+        }
+    }
+    return 0;
+}
+
+// 主动停机，AWU定时唤醒，唤醒后补偿TIM4停止期间的tick
+static void bsp_pwr_active_halt(uint8_t tb, uint32_t sleep_us)
+{
+    bsp_pwr_notify_all(BSP_PWR_EVT_ENTER);
+    AWU->TBR = tb;
+    bsp_pwr_awu_fired = FALSE;
+    AWU->CSR |= AWU_CSR_AWUEN;
+    halt(); // 同时开中断，唤醒后先执行中断服务
+    AWU->CSR &= (uint8_t)(~AWU_CSR_AWUEN);
+    if (!bsp_pwr_awu_fired)
+    {
+        // 被外部中断提前唤醒，实际休眠时间未知
+        sleep_us /= 2;
+        bsp_pwr_stats.early_wake++;
+    }
+    sys_timer_add_us(sleep_us);
+    bsp_pwr_notify_all(BSP_PWR_EVT_EXIT);
+    bsp_pwr_account(BSP_PWR_MODE_ACTIVE_HALT, sleep_us);
+}
+
+// 空闲处理，在主循环每次调度后调用。到期时间在关中断后计算，中断产生的事件不会被遗漏：
+// wfi/halt指令同时开中断，关中断期间挂起的中断会立即唤醒
+void bsp_pwr_idle(bsp_pwr_deadline_t deadline)
+{
+    uint32_t ticks;
+    uint32_t start;
+    uint32_t sleep_us;
+    uint8_t tb = 0;
+
+    if (bsp_pwr_mode_max == BSP_PWR_MODE_RUN)
+    {
+        return;
+    }
+    disableInterrupts();
+    ticks = deadline();
+    if (ticks == 0)
+    {
+        enableInterrupts();
+        bsp_pwr_stats.count[BSP_PWR_MODE_RUN]++;
+        return;
+    }
+    if (bsp_pwr_mode_max >= BSP_PWR_MODE_ACTIVE_HALT && !bsp_pwr_busy())
+    {
+        if (ticks == BSP_PWR_DEADLINE_NONE && bsp_pwr_mode_max == BSP_PWR_MODE_HALT)
+        {
+            bsp_pwr_notify_all(BSP_PWR_EVT_ENTER);
+            halt();
+            bsp_pwr_notify_all(BSP_PWR_EVT_EXIT);
+            bsp_pwr_account(BSP_PWR_MODE_HALT, 0);
+            return;
+        }
+        tb = bsp_pwr_awu_select(ticks, &sleep_us);
+    }
+    if (tb != 0)
+    {
+        bsp_pwr_active_halt(tb, sleep_us);
+        return;
+    }
+    start = sys_timer_get_us();
+    wfi();
+    bsp_pwr_account(BSP_PWR_MODE_WAIT, sys_timer_get_us() - start);
+}
+
+// 设置允许的最深模式，LSI不可用时（未测得频率）最深为WAIT
+void bsp_pwr_set_max_mode(bsp_pwr_mode_t mode)
+{
+    if (mode >= BSP_PWR_MODE_NUM)
+    {
+        return;
+    }
+    if (bsp_pwr_stats.lsi_hz == 0 && mode > BSP_PWR_MODE_WAIT)
+    {
+        mode = BSP_PWR_MODE_WAIT;
+    }
+    bsp_pwr_mode_max = mode;
+}
+
+bsp_pwr_mode_t bsp_pwr_get_max_mode(void)
+{
+    return bsp_pwr_mode_max;
+}
+
+void bsp_pwr_get_stats(bsp_pwr_stats_t *stats)
+{
+    *stats = bsp_pwr_stats;
+}
+
+// AWU中断：读CSR清除AWUF
+INTERRUPT_HANDLER(AWU_IRQHandler, 1)
+{
+    (void)AWU->CSR;
+    bsp_pwr_awu_fired = TRUE;
+}
@@ -0,0 +1,60 @@
+#ifndef __BSP_PWR_H__
+#define __BSP_PWR_H__
+
+#include "stm8s.h"
+
+/*
+ * 低功耗管理：主循环每次调度后调用bsp_pwr_idle，按下一个任务到期时间和各模块的活动状态选择
+ *
+ * WAIT         wfi，外设和系统定时器继续运行，任何中断唤醒（tick中断保证不超过1个tick）
+ * ACTIVE_HALT  停机，AWU（LSI）定时唤醒，主时钟、TIM4和串口停止，唤醒后按休眠时间补偿tick
+ * HALT         停机且不开AWU，只能由外部中断唤醒，没有周期任务时才使用，停机期间系统时间不前进
+ *
+ * 模块通过bsp_pwr_hook_register注册钩子：CHECK时返回TRUE表示正在工作，不允许停机（只能WAIT），
+ * ENTER/EXIT在停机前后调用（配置唤醒源），ENTER时已关中断
+ */
+
+// 低功耗模式，按深度排列
+typedef enum
+{
+    BSP_PWR_MODE_RUN = 0,       // 不休眠
+    BSP_PWR_MODE_WAIT,
+    BSP_PWR_MODE_ACTIVE_HALT,
+    BSP_PWR_MODE_HALT,
+    BSP_PWR_MODE_NUM,
+} bsp_pwr_mode_t;
+
+#define BSP_PWR_MODE_MAX        BSP_PWR_MODE_ACTIVE_HALT // 默认允许的最深模式，可用bsp_pwr_set_max_mode修改
+#define BSP_PWR_HOOK_MAX        4           // 可注册的钩子数量
+#define BSP_PWR_AHALT_MIN_US    2000UL      // 主动停机的最短时间，更短时使用WAIT（唤醒需要重新启动主电压调节器和Flash）
+#define BSP_PWR_DEADLINE_NONE   0xFFFFFFFFUL // 没有周期任务
+
+// 钩子事件
+typedef enum
+{
+    BSP_PWR_EVT_CHECK = 0,  // 查询是否正在工作
+    BSP_PWR_EVT_ENTER,      // 即将停机
+    BSP_PWR_EVT_EXIT,       // 停机唤醒
+} bsp_pwr_event_t;
+
+typedef bool (*bsp_pwr_hook_t)(bsp_pwr_event_t event);
+// 返回距离下一个任务到期的tick数，0表示有任务需要立即运行
+typedef uint32_t (*bsp_pwr_deadline_t)(void);
+
+// 各模式的驻留统计，RUN为有任务到期而没有休眠的次数
+typedef struct
+{
+    uint32_t count[BSP_PWR_MODE_NUM];
+    uint32_t time_ms[BSP_PWR_MODE_NUM]; // HALT期间没有时钟，不计时间
+    uint16_t early_wake;                // 主动停机被外部中断提前唤醒的次数，此时按休眠时间的一半补偿
+    uint32_t lsi_hz;                    // 测得的LSI频率
+} bsp_pwr_stats_t;
+
+void bsp_pwr_init(void);
+bool bsp_pwr_hook_register(bsp_pwr_hook_t hook);
+void bsp_pwr_idle(bsp_pwr_deadline_t deadline);
+void bsp_pwr_set_max_mode(bsp_pwr_mode_t mode);
+bsp_pwr_mode_t bsp_pwr_get_max_mode(void);
+void bsp_pwr_get_stats(bsp_pwr_stats_t *stats);
+
+#endif
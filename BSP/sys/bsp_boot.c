@@ -0,0 +1,22 @@
+#include "bsp_sys_pub.h"
+
+static bsp_boot_mark_t bsp_boot_marks[BSP_BOOT_MARK_MAX];
+static uint8_t bsp_boot_mark_num = 0;
+
+// 记录一个启动阶段的结束时间，name须为常量字符串
+void bsp_boot_mark(const char *name)
+{
+    if (bsp_boot_mark_num >= BSP_BOOT_MARK_MAX)
+    {
+        return;
+    }
+    bsp_boot_marks[bsp_boot_mark_num].name = name;
+    bsp_boot_marks[bsp_boot_mark_num].us = sys_timer_get_us();
+    bsp_boot_mark_num++;
+}
+
+// 按记录顺序获取阶段，超出范围返回NULL
+const bsp_boot_mark_t *bsp_boot_get(uint8_t index)
+{
+    return index < bsp_boot_mark_num ? &bsp_boot_marks[index] : NULL;
+}
@@ -0,0 +1,26 @@
+#ifndef __BSP_BOOT_H__
+#define __BSP_BOOT_H__
+
+#include "stm8s.h"
+
+/*
+ * 启动过程计时：各初始化阶段结束时调用bsp_boot_mark记录sys_timer_get_us时间戳，boot命令查看。
+ * 时间从TIM4启动（sys_timer_init）开始计，之前的启动代码和时钟配置不计入
+ *
+ * BSP_FAST_BOOT为1时尽快进入第一次调度：欢迎信息、任务列表、上电脚本和延时循环校准
+ * 由后台任务在第一次调度时完成（delay_us/delay_ms以定时器计时，只有关中断时的长延时在校准前按16MHz估算值执行循环）
+ */
+
+#define BSP_FAST_BOOT           0
+#define BSP_BOOT_MARK_MAX       12    // 最多记录的阶段数，超出的不记录
+
+typedef struct
+{
+    const char *name;
+    uint32_t us;
+} bsp_boot_mark_t;
+
+void bsp_boot_mark(const char *name);
+const bsp_boot_mark_t *bsp_boot_get(uint8_t index);
+
+#endif
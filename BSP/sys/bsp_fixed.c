@@ -0,0 +1,173 @@
+#include "bsp_fixed.h"
+
+const uint32_t fixed_pow10[FIXED_POW10_NUM] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL,
+    100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL,
+};
+
+// 按符号返回结果，超出范围时饱和
+static fixed_t fixed_sign(uint32_t magnitude, bool negative)
+{
+    if (negative)
+    {
+        return magnitude >= 0x80000000UL ? FIXED_MIN : -(fixed_t)magnitude;
+    }
+    return magnitude > 0x7FFFFFFFUL ? FIXED_MAX : (fixed_t)magnitude;
+}
+
+// 取绝对值（FIXED_MIN的绝对值0x80000000用无符号数表示）
+static uint32_t fixed_abs(fixed_t value)
+{
+    return value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+}
+
+// Q16.16乘法，向0截断：|a|*|b|>>16 拆成16位分段乘积之和
+fixed_t fixed_mul(fixed_t a, fixed_t b)
+{
+    uint32_t ua = fixed_abs(a);
+    uint32_t ub = fixed_abs(b);
+    uint16_t ah = (uint16_t)(ua >> 16), al = (uint16_t)ua;
+    uint16_t bh = (uint16_t)(ub >> 16), bl = (uint16_t)ub;
+    bool negative = ((a < 0) != (b < 0)) ? TRUE : FALSE;
+    uint32_t hi = (uint32_t)ah * bh;
+    uint32_t result;
+    uint32_t part;
+
+    if (hi > 0xFFFFUL)
+    {
+        return fixed_sign(0xFFFFFFFFUL, negative);
+    }
+    result = hi << 16;
+    part = (uint32_t)ah * bl;
+    result += part;
+    if (result < part)
+    {
+        return fixed_sign(0xFFFFFFFFUL, negative);
+    }
+    part = (uint32_t)al * bh;
+    result += part;
+    if (result < part)
+    {
+        return fixed_sign(0xFFFFFFFFUL, negative);
+    }
+    part = ((uint32_t)al * bl) >> 16;
+    result += part;
+    if (result < part)
+    {
+        return fixed_sign(0xFFFFFFFFUL, negative);
+    }
+    return fixed_sign(result, negative);
+}
+
+// Q16.16除法，向0截断：先求整数部分，再对余数逐位做16次长除法。除数为0时饱和
+fixed_t fixed_div(fixed_t a, fixed_t b)
+{
+    uint32_t ua = fixed_abs(a);
+    uint32_t ub = fixed_abs(b);
+    bool negative = ((a < 0) != (b < 0)) ? TRUE : FALSE;
+    uint32_t quotient;
+    uint32_t remainder;
+    uint8_t carry;
+    uint8_t i;
+
+    if (ub == 0)
+    {
+        return fixed_sign(0xFFFFFFFFUL, negative);
+    }
+    quotient = ua / ub;
+    if (quotient > 0xFFFFUL)
+    {
+        return fixed_sign(0xFFFFFFFFUL, negative);
+    }
+    remainder = ua % ub;
+    for (i = 0; i < FIXED_FRAC_BITS; i++)
+    {
+        // 余数小于除数，左移后可能超过32位，最高位移出时一定不小于除数
+        carry = (remainder & 0x80000000UL) ? 1 : 0;
+        remainder <<= 1;
+        quotient <<= 1;
+        if (carry || remainder >= ub)
+        {
+            remainder -= ub;
+            quotient |= 1;
+        }
+    }
+    return fixed_sign(quotient, negative);
+}
+
+// Q15乘法，四舍五入，-1*-1饱和
+int16_t q15_mul(int16_t a, int16_t b)
+{
+    int32_t result = ((int32_t)a * b + 0x4000) >> 15;
+
+    return result > 0x7FFF ? 0x7FFF : (int16_t)result;
+}
+
+// |value|*10^n/65536 = 高16位*10^n + (低16位*10^n)>>16，n不超过4时各项都不超过32位，结果为精确的向下取整
+int32_t fixed_to_dec(fixed_t value, uint8_t decimals)
+{
+    uint32_t magnitude = fixed_abs(value);
+    uint32_t scale;
+    uint32_t result;
+
+    if (decimals > FIXED_DEC_MAX)
+    {
+        decimals = FIXED_DEC_MAX;
+    }
+    scale = fixed_pow10[decimals];
+    result = (magnitude >> 16) * scale + (((magnitude & 0xFFFFUL) * scale) >> 16);
+    return value < 0 ? -(int32_t)result : (int32_t)result;
+}
+
+// value*65536/10^n，整数部分和余数分别换算
+fixed_t fixed_from_dec(int32_t value, uint8_t decimals)
+{
+    uint32_t magnitude = fixed_abs(value);
+    uint32_t scale;
+    uint32_t integer;
+    uint32_t remainder;
+
+    if (decimals > FIXED_DEC_MAX)
+    {
+        decimals = FIXED_DEC_MAX;
+    }
+    scale = fixed_pow10[decimals];
+    integer = magnitude / scale;
+    remainder = magnitude % scale;
+    if (integer > 0xFFFFUL)
+    {
+        return fixed_sign(0xFFFFFFFFUL, value < 0);
+    }
+    return fixed_sign((integer << 16) + ((remainder << 16) + scale / 2) / scale, value < 0);
+}
+
+// 拆分按10^decimals放大的整数
+void fixed_split(int32_t value, uint8_t decimals, int32_t *integer, uint32_t *fraction)
+{
+    uint32_t magnitude = fixed_abs(value);
+    uint32_t scale;
+
+    if (decimals >= FIXED_POW10_NUM)
+    {
+        decimals = FIXED_POW10_NUM - 1;
+    }
+    scale = fixed_pow10[decimals];
+    *integer = value / (int32_t)scale;
+    *fraction = magnitude % scale;
+}
+
+// 取定点数dt的前deci位小数（1~4位），如dt为1.2345、deci为2时返回23。
+// 与原double版本 (u16)((long)(dt*10^deci) % 10^deci) 的结果逐位相同（负数同样按C的取余和u16转换）
+u16 Get_decimal(fixed_t dt, u8 deci)
+{
+    int32_t x1;
+    u16 x3;
+
+    if (deci > FIXED_DEC_MAX) deci = FIXED_DEC_MAX;
+    if (deci < 1) deci = 1;
+
+    x3 = (u16)fixed_pow10[deci];
+    x1 = fixed_to_dec(dt, deci);
+
+    return (u16)(x1 % x3);
+}
@@ -0,0 +1,49 @@
+#ifndef __BSP_FIXED_H__
+#define __BSP_FIXED_H__
+
+#include "stm8s.h"
+
+/*
+ * 定点数运算，替代double和math.h（STM8没有FPU，软件浮点库每次运算上千周期且占用大量Flash）
+ *
+ * fixed_t   Q16.16，范围约±32768，分辨率1/65536
+ * Q15       int16_t，范围[-1, 1)，用于系数等
+ *
+ * 乘除法以16位分段计算，不需要64位中间结果；溢出时饱和到最大/最小值
+ * 显示时先用fixed_to_dec换算为按10^n放大的整数，再用bsp_printf的%q输出，如
+ *     bsp_printf("%.2q", fixed_to_dec(x, 2));
+ */
+
+typedef int32_t fixed_t;
+
+#define FIXED_FRAC_BITS         16
+#define FIXED_ONE               ((fixed_t)1 << FIXED_FRAC_BITS)
+#define FIXED_MAX               ((fixed_t)0x7FFFFFFFL)
+#define FIXED_MIN               ((fixed_t)(-0x7FFFFFFFL - 1))
+#define FIXED_DEC_MAX           4     // fixed_to_dec支持的最大小数位数
+
+// 编译期常量转换，如 FIXED_CONST(3.25)，只能用于常量表达式（由编译器计算，不引入浮点运算）
+#define FIXED_CONST(x)          ((fixed_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define FIXED_FROM_INT(i)       ((fixed_t)(i) * FIXED_ONE)
+#define Q15_CONST(x)            ((int16_t)((x) * 32768.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+// 10的幂表，10^0 ~ 10^9
+#define FIXED_POW10_NUM         10
+extern const uint32_t fixed_pow10[FIXED_POW10_NUM];
+
+fixed_t fixed_mul(fixed_t a, fixed_t b);
+fixed_t fixed_div(fixed_t a, fixed_t b);
+int16_t q15_mul(int16_t a, int16_t b);
+
+// 按10^decimals放大取整（向0截断），decimals不超过FIXED_DEC_MAX
+int32_t fixed_to_dec(fixed_t value, uint8_t decimals);
+// 按10^decimals放大的整数转换为定点数（四舍五入）
+fixed_t fixed_from_dec(int32_t value, uint8_t decimals);
+
+// 拆分按10^decimals放大的整数：整数部分（向0截断）和小数部分的绝对值
+void fixed_split(int32_t value, uint8_t decimals, int32_t *integer, uint32_t *fraction);
+
+// 取定点数的前deci位小数（兼容原double接口）
+u16 Get_decimal(fixed_t dt, u8 deci);
+
+#endif
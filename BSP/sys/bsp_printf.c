@@ -0,0 +1,308 @@
+#include "bsp_printf.h"
+#include "bsp_uart.h"
+#include <string.h>
+
+// 输出目标
+typedef struct
+{
+    char *buf;       // 缓冲区
+    uint16_t size;   // 缓冲区大小
+    uint16_t pos;    // 当前写入位置
+    uint16_t count;  // 已输出字符总数
+    bool flush;      // 缓冲区满时是否输出到UART（否则截断）
+} bsp_printf_out_t;
+
+// 输出一个字符
+static void bsp_printf_putc(bsp_printf_out_t *out, char c)
+{
+    out->count++;
+    if (out->pos >= out->size)
+    {
+        if (!out->flush)
+        {
+            return; // 缓冲区已满，截断
+        }
+        uart_stdout_write((const uint8_t *)out->buf, out->pos);
+        out->pos = 0;
+    }
+    out->buf[out->pos++] = c;
+}
+
+// 输出字符串并按宽度填充
+static void bsp_printf_puts(bsp_printf_out_t *out, const char *str, uint8_t len,
+                            uint8_t width, bool left, char pad)
+{
+#if BSP_PRINTF_USE_WIDTH
+    uint8_t fill = (width > len) ? (uint8_t)(width - len) : 0;
+
+    // 负数补0时，符号在填充字符之前
+    if (pad == '0' && *str == '-' && len > 0)
+    {
+        bsp_printf_putc(out, *str++);
+        len--;
+    }
+    while (!left && fill > 0)
+    {
+        bsp_printf_putc(out, pad);
+        fill--;
+    }
+#endif
+    while (len > 0)
+    {
+        bsp_printf_putc(out, *str++);
+        len--;
+    }
+#if BSP_PRINTF_USE_WIDTH
+    while (fill > 0)
+    {
+        bsp_printf_putc(out, ' ');
+        fill--;
+    }
+#endif
+}
+
+// 无符号整数转十进制字符串，从buf末尾向前写，返回起始位置
+static char *bsp_printf_utoa(char *end, uint32_t value)
+{
+#if BSP_PRINTF_USE_LONG
+    // 超过16位时才使用32位除法，STM8上16位除法快得多
+    while (value > 0xFFFF)
+    {
+        *--end = (char)('0' + value % 10);
+        value /= 10;
+    }
+#endif
+    {
+        uint16_t v = (uint16_t)value;
+        do
+        {
+            *--end = (char)('0' + v % 10);
+            v /= 10;
+        } while (v);
+    }
+    return end;
+}
+
+// 格式化核心
+static void bsp_printf_format(bsp_printf_out_t *out, const char *fmt, va_list ap)
+{
+    char num[13]; // 32位十进制最长10位 + 符号 + 小数点
+    char *end = &num[sizeof(num)];
+
+    while (*fmt)
+    {
+        char c = *fmt++;
+        char *str;
+        uint8_t width = 0;
+        uint8_t prec = 0;
+        bool left = FALSE;
+        char pad = ' ';
+        bool is_long = FALSE;
+        bool neg = FALSE;
+        uint32_t value;
+
+        if (c != '%')
+        {
+            bsp_printf_putc(out, c);
+            continue;
+        }
+
+        // 标志和宽度
+        for (;; fmt++)
+        {
+            if (*fmt == '-')
+            {
+                left = TRUE;
+            }
+            else if (*fmt == '0')
+            {
+                pad = '0';
+            }
+            else
+            {
+                break;
+            }
+        }
+        while (*fmt >= '0' && *fmt <= '9')
+        {
+            width = (uint8_t)(width * 10 + (*fmt++ - '0'));
+        }
+        if (*fmt == '.')
+        {
+            fmt++;
+            while (*fmt >= '0' && *fmt <= '9')
+            {
+                prec = (uint8_t)(prec * 10 + (*fmt++ - '0'));
+            }
+        }
+        if (*fmt == 'l')
+        {
+            is_long = TRUE;
+            fmt++;
+        }
+        if (left)
+        {
+            pad = ' ';
+        }
+
+        c = *fmt++;
+        switch (c)
+        {
+        case 'd':
+        case 'i':
+#if BSP_PRINTF_USE_FIXED
+        case 'q':
+#endif
+#if BSP_PRINTF_USE_LONG
+            if (is_long)
+            {
+                int32_t v = va_arg(ap, int32_t);
+                neg = (v < 0) ? TRUE : FALSE;
+                value = neg ? (uint32_t)0 - (uint32_t)v : (uint32_t)v;
+            }
+            else
+#endif
+            {
+                int v = va_arg(ap, int);
+                neg = (v < 0) ? TRUE : FALSE;
+                value = neg ? (uint16_t)(0 - (uint16_t)v) : (uint16_t)v;
+            }
+            str = bsp_printf_utoa(end, value);
+#if BSP_PRINTF_USE_FIXED
+            if (c == 'q' && prec > 0)
+            {
+                // 不足小数位数时补0，再插入小数点
+                if (prec > 9)
+                {
+                    prec = 9;
+                }
+                while (end - str <= prec)
+                {
+                    *--str = '0';
+                }
+                memmove(str - 1, str, end - str - prec);
+                str--;
+                end[-prec - 1] = '.';
+            }
+#endif
+            if (neg)
+            {
+                *--str = '-';
+            }
+            bsp_printf_puts(out, str, (uint8_t)(end - str), width, left, pad);
+            break;
+
+        case 'u':
+#if BSP_PRINTF_USE_LONG
+            value = is_long ? va_arg(ap, uint32_t) : (unsigned int)va_arg(ap, unsigned int);
+#else
+            value = (unsigned int)va_arg(ap, unsigned int);
+#endif
+            str = bsp_printf_utoa(end, value);
+            bsp_printf_puts(out, str, (uint8_t)(end - str), width, left, pad);
+            break;
+
+#if BSP_PRINTF_USE_HEX
+        case 'x':
+        case 'X':
+        {
+            const char *digits = (c == 'x') ? "0123456789abcdef" : "0123456789ABCDEF";
+#if BSP_PRINTF_USE_LONG
+            value = is_long ? va_arg(ap, uint32_t) : (unsigned int)va_arg(ap, unsigned int);
+#else
+            value = (unsigned int)va_arg(ap, unsigned int);
+#endif
+            str = end;
+            do
+            {
+                *--str = digits[value & 0x0F];
+                value >>= 4;
+            } while (value);
+            bsp_printf_puts(out, str, (uint8_t)(end - str), width, left, pad);
+            break;
+        }
+#endif
+
+        case 'c':
+            num[0] = (char)va_arg(ap, int);
+            bsp_printf_puts(out, num, 1, width, left, ' ');
+            break;
+
+        case 's':
+            str = va_arg(ap, char *);
+            if (str == NULL)
+            {
+                str = "(null)";
+            }
+            {
+                size_t len = strlen(str);
+                bsp_printf_puts(out, str, (uint8_t)((len > 0xFF) ? 0xFF : len), width, left, ' ');
+            }
+            break;
+
+        case '%':
+            bsp_printf_putc(out, '%');
+            break;
+
+        case '\0':
+            return; // 格式串以'%'结尾
+
+        default:
+            // 不支持的转换原样输出
+            bsp_printf_putc(out, '%');
+            bsp_printf_putc(out, c);
+            break;
+        }
+    }
+}
+
+// 格式化输出到UART标准输出
+int bsp_vprintf(const char *fmt, va_list ap)
+{
+    char chunk[BSP_PRINTF_CHUNK_SIZE];
+    bsp_printf_out_t out = {chunk, sizeof(chunk), 0, 0, TRUE};
+
+    bsp_printf_format(&out, fmt, ap);
+    if (out.pos > 0)
+    {
+        uart_stdout_write((const uint8_t *)chunk, out.pos);
+    }
+    return out.count;
+}
+
+int bsp_printf(const char *fmt, ...)
+{
+    va_list ap;
+    int ret;
+
+    va_start(ap, fmt);
+    ret = bsp_vprintf(fmt, ap);
+    va_end(ap);
+    return ret;
+}
+
+// 格式化到缓冲区
+int bsp_vsnprintf(char *buf, uint16_t size, const char *fmt, va_list ap)
+{
+    bsp_printf_out_t out = {buf, 0, 0, 0, FALSE};
+
+    if (size == 0)
+    {
+        return 0;
+    }
+    out.size = size - 1; // 保留结束符位置
+    bsp_printf_format(&out, fmt, ap);
+    buf[out.pos] = '\0';
+    return out.pos;
+}
+
+int bsp_snprintf(char *buf, uint16_t size, const char *fmt, ...)
+{
+    va_list ap;
+    int ret;
+
+    va_start(ap, fmt);
+    ret = bsp_vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    return ret;
+}
@@ -0,0 +1,31 @@
+#ifndef __BSP_PRINTF_H__
+#define __BSP_PRINTF_H__
+
+#include "stm8s.h"
+#include <stdarg.h>
+
+/*
+ * 轻量级格式化输出，替代工具链printf
+ *
+ * 支持：%d %i %u %x %X %c %s %%，'l'长度修饰（32位），'-'、'0'标志和宽度
+ * 扩展：%q 定点数，精度为小数位数，如 bsp_printf("%.2q", 1234) 输出 "12.34"
+ * 不支持浮点数
+ */
+
+// 编译期裁剪，未使用的转换设为0可减小代码
+#define BSP_PRINTF_USE_LONG     1     // 'l'长度修饰（32位整数）
+#define BSP_PRINTF_USE_HEX      1     // %x %X
+#define BSP_PRINTF_USE_FIXED    1     // %q 定点数
+#define BSP_PRINTF_USE_WIDTH    1     // 宽度、'-'和'0'标志
+
+#define BSP_PRINTF_CHUNK_SIZE   16    // bsp_printf输出缓冲区大小（位于栈上）
+
+// 格式化输出到UART标准输出（受uart_set_stdout_hook重定向），返回输出字符数
+int bsp_printf(const char *fmt, ...);
+int bsp_vprintf(const char *fmt, va_list ap);
+
+// 格式化到缓冲区，结果总是以'\0'结尾，返回写入的字符数（不含结束符）
+int bsp_snprintf(char *buf, uint16_t size, const char *fmt, ...);
+int bsp_vsnprintf(char *buf, uint16_t size, const char *fmt, va_list ap);
+
+#endif
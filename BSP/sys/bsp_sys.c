@@ -2,15 +2,35 @@
 
 void bsp_sys_init(void)
 {
+    uint8_t reset_flags = RST->SR;
+
+    RST->SR = reset_flags; // 写1清除，下次复位只保留新的原因
+
     bsp_clk_config_init(); // 时钟配置初始化
     sys_timer_init();      // 系统定时器初始化
-    uart_hw_init(115200);  // UART1初始化
+    bsp_boot_mark("timer");
+#if !BSP_FAST_BOOT
+    delay_calibrate();     // 以系统定时器校准延时循环，快速启动时由后台任务完成
+    bsp_boot_mark("delay");
+#endif
+    uart_hw_init(UART_CONSOLE_BAUDRATE); // 控制台初始化，开启自动波特率时收到同步字符后切换
+    bsp_boot_mark("uart");
+    // 时钟切换通知：先更新系统定时器，延时校准依赖它，串口最后按新时钟计算波特率
+    bsp_clk_notify_register(sys_timer_clk_notify);
+    bsp_clk_notify_register(delay_clk_notify);
+    bsp_clk_notify_register(uart_clk_notify);
+    bsp_clk_set_mode(BSP_CLK_BOOT_MODE); // 失败时保持上电时钟，已记录日志
+    bsp_boot_mark("clk");
+    bsp_pwr_init();                      // 校准AWU，主循环空闲时休眠
+    bsp_pwr_hook_register(uart_pwr_hook);
+    bsp_boot_mark("pwr");
+    BSP_LOG1(SYS_BOOT, reset_flags);
 }
 
 void assert_failed(uint8_t *file, uint32_t line)
 {
     // 输出断言失败信息到串口（假设已初始化UART）
-    printf("Assert failed: file %s, line %lu\r\n", file, line);
+    bsp_printf("Assert failed: file %s, line %lu\r\n", file, line);
 
     // 断言失败后进入死循环，防止程序继续运行
     while (1)
@@ -1,30 +1,134 @@
 #include "bsp_sys_pub.h"
 
-void delay_us(u16 nCount)
+#define DELAY_CALIBRATE_LOOPS   4000  // 校准时执行的循环次数（16MHz下约1ms）
+#define DELAY_CYCLES_MASKED_MAX 0xFF00 // 关中断时以TIM3计时的最大周期数，留出最后一次查询的余量，不超过一次回绕
+
+// 每毫秒的循环次数及每微秒循环次数（Q8），由delay_calibrate测量得到，初值按16MHz每次4周期估算。
+// 只用于关中断时超过一次TIM3回绕的延时和系统定时器启动之前
+static uint16_t delay_loops_per_ms = 4000;
+static uint16_t delay_loops_per_us_q8 = 1024;
+
+// 延时循环，每次循环的周期数取决于编译器和优化等级，由校准消除
+static void delay_loop(uint16_t n)
 {
-    nCount *=3;
-    while(--nCount);
+    while (n--)
+    {
+        nop();
+    }
 }
 
-void delay_ms(u16 nCount)
+// 按DELAY_CALIBRATE_LOOPS次循环的测量时间（us）设置循环参数
+static void delay_calibrate_set(uint32_t best)
 {
-    while(nCount--)
+    uint32_t loops;
+
+    if (best == 0)
+    {
+        best = 1;
+    }
+    // 测量值异常时饱和而不是截断回绕（每毫秒超过65535次循环或不足1次）
+    loops = (uint32_t)DELAY_CALIBRATE_LOOPS * 1000 / best;
+    if (loops > 0xFFFF)
+    {
+        loops = 0xFFFF;
+    }
+    else if (loops == 0)
     {
-        delay_us(1000);
+        loops = 1;
     }
+    delay_loops_per_ms = (uint16_t)loops;
+    delay_loops_per_us_q8 = (uint16_t)((loops * 256 + 500) / 1000); // 不超过16777
 }
 
-u16 Get_decimal(double dt,u8 deci)
+// 用系统定时器的微秒时间戳测量延时循环的实际速度，主时钟改变后需重新调用。
+// 测量两次取较快的一次，排除期间发生的中断
+void delay_calibrate(void)
 {
-    long x1=0;
-    u16 x2=0,x3=0;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t best = 0xFFFFFFFFUL;
+    uint8_t i;
 
-    if(deci>4) deci=4;
-    if(deci<1) deci=1;
+    for (i = 0; i < 2; i++)
+    {
+        start = sys_timer_get_us();
+        delay_loop(DELAY_CALIBRATE_LOOPS);
+        elapsed = sys_timer_get_us() - start;
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    delay_calibrate_set(best);
+}
 
-    x3=(u16)pow(10, deci);
-    x1=(long)(dt*x3);
-    x2=(u16)(x1%x3);
+// 时钟切换通知，CPU频率变化后重新校准
+void delay_clk_notify(bsp_clk_event_t event, uint32_t fmaster)
+{
+    (void)fmaster;
+    if (event == BSP_CLK_EVT_POST)
+    {
+        delay_calibrate();
+    }
+}
 
-    return x2;
+// 按校准结果执行循环的微秒延时
+static void delay_us_loop(u16 nCount)
+{
+    while (nCount >= 1000)
+    {
+        delay_loop(delay_loops_per_ms);
+        nCount -= 1000;
+    }
+    delay_loop((uint16_t)(((uint32_t)nCount * delay_loops_per_us_q8) >> 8));
+}
+
+// 微秒延时，等待TIM3周期计数经过nCount*MHz个周期（分辨率一个主时钟周期，时钟切换后不需重新校准），
+// 期间发生的中断只会使延时变长，可在中断中或关中断时使用。
+// 关中断（或在中断中）时TIM3溢出中断不会执行，只比较计数的低16位，不超过一次回绕（16MHz下约4ms）；
+// 关中断时更长的延时和系统定时器启动之前改用校准的循环
+void delay_us(u16 nCount)
+{
+    uint32_t cycles = (uint32_t)nCount * sys_timer_get_mhz();
+    uint32_t start;
+
+    if ((__get_interrupt_state() & CPU_CC_I1I0) != CPU_CC_I1I0 && cycles != 0)
+    {
+        start = sys_timer_get_cycles();
+        while (sys_timer_get_cycles() - start < cycles)
+        {
+        }
+    }
+    else if (cycles != 0 && cycles <= DELAY_CYCLES_MASKED_MAX)
+    {
+        start = sys_timer_get_cycles();
+        while ((uint16_t)(sys_timer_get_cycles() - start) < (uint16_t)cycles)
+        {
+        }
+    }
+    else
+    {
+        delay_us_loop(nCount);
+    }
+}
+
+// 毫秒延时，以系统定时器的微秒时间戳为基准，不受中断影响。关中断（或在中断中）时定时器溢出中断不会执行，
+// 按1ms分段用delay_us（每段不超过一次TIM3回绕）
+void delay_ms(u16 nCount)
+{
+    uint32_t start;
+    uint32_t duration = (uint32_t)nCount * 1000;
+
+    if ((__get_interrupt_state() & CPU_CC_I1I0) == CPU_CC_I1I0)
+    {
+        while (nCount--)
+        {
+            delay_us(1000);
+        }
+        return;
+    }
+    start = sys_timer_get_us();
+    while (sys_timer_get_us() - start < duration)
+    {
+    }
 }
@@ -3,15 +3,20 @@
 #include "stm8s.h"
 #include <stdio.h>
 #include <string.h>
-#include "math.h"
 
 #include "bsp_clk.h"
+#include "bsp_pwr.h"
 #include "bsp_uart.h"
 #include "sys_timer.h"
+#include "bsp_printf.h"
+#include "bsp_fixed.h"
+#include "bsp_log.h"
+#include "bsp_boot.h"
 
 void delay_us(u16 nCount);
 void delay_ms(u16 nCount);
-u16 Get_decimal(double dt, u8 deci);
+void delay_calibrate(void);
+void delay_clk_notify(bsp_clk_event_t event, uint32_t fmaster);
 void bsp_sys_init(void);
 void assert_failed(uint8_t *file, uint32_t line);
 
@@ -1,45 +1,356 @@
 #include "stm8s_tim4.h"
 #include "bsp_sys_pub.h"
 
-volatile uint32_t system_ticks = 0;   // 系统tick计数
-volatile uint32_t system_time_ms = 0; // 系统时间（毫秒）
-volatile uint32_t system_time_s = 0;  // 系统时间（秒）
-uint16_t count_1000_tick = 0;         // 1000ms 计数器
+// tick计数，中断中只更新这一个计数，毫秒和秒在读取时换算
+static volatile uint32_t sys_ticks = 0;
+
+// 当前主时钟下的TIM4时基：预分频2^shift，每tick base或base+1个计数（frac/2^shift的tick取base+1）
+static uint8_t sys_timer_shift;
+static uint8_t sys_timer_base;   // 短周期的计数个数减1（即ARR）
+static uint8_t sys_timer_frac;   // 为0时周期固定
+static uint8_t sys_timer_acc;
+static uint8_t sys_timer_mhz;    // 主时钟MHz数，用于计数换算微秒
+
+// 高分辨率时间：TIM3以主时钟自由运行（16位），溢出中断把65536个周期折算为微秒累加到sys_us_base
+static volatile uint32_t sys_us_base;    // 截至最近一次溢出的微秒数
+static volatile uint8_t sys_us_rem;      // 折算后不足1us的周期数（小于sys_timer_mhz）
+static volatile uint16_t sys_cycles_high; // 溢出次数，与TIM3计数组成32位周期计数
+static uint16_t sys_ovf_us;              // 每次溢出的整微秒数（65536/MHz）
+static uint8_t sys_ovf_rem;              // 每次溢出不足1us的周期数（65536%MHz）
+
+// 编译期检查：切换到HSE模式后一个tick仍能用TIM4表示，否则tick变长而SYS_TICK_US等换算不变，计时整体偏慢
+typedef char sys_timer_hse_tick_check[((HSE_VALUE + SYS_TICK_HZ / 2) / SYS_TICK_HZ <= SYS_TICK_CYCLES_MAX) ? 1 : -1];
+
+// 读取TIM3计数及对应的累计值，调用时须已关中断。计数已回绕但溢出中断还未处理时
+// （调用方关中断或在其他中断中），补上这次溢出并重新读取计数
+static uint16_t sys_timer_cnt3_read(uint32_t *base, uint16_t *rem, uint16_t *high)
+{
+    uint8_t byte = TIM3->CNTRH; // 先读高字节锁存低字节
+    uint16_t count = ((uint16_t)byte << 8) | TIM3->CNTRL;
+
+    *base = sys_us_base;
+    *rem = sys_us_rem;
+    *high = sys_cycles_high;
+    if (TIM3->SR1 & TIM3_SR1_UIF)
+    {
+        byte = TIM3->CNTRH;
+        count = ((uint16_t)byte << 8) | TIM3->CNTRL;
+        *base += sys_ovf_us;
+        *rem += sys_ovf_rem;
+        (*high)++;
+    }
+    return count;
+}
+
+// 按主时钟计算并设置TIM4时基。重新加载预分频会使当前tick提前结束（少计不到1个tick）。
+// TIM3已计的周期按原频率计入微秒后从0重新计数（舍去不足1us的部分）
+static void sys_timer_set_fmaster(uint32_t fmaster)
+{
+    uint32_t cycles = (fmaster + SYS_TICK_HZ / 2) / SYS_TICK_HZ;
+    uint8_t shift = 0;
+    uint8_t mhz = fmaster >= 1000000UL ? (uint8_t)(fmaster / 1000000UL) : 1;
+    uint32_t base;
+    uint16_t rem;
+    uint16_t high;
+    uint16_t count;
+    __istate_t istate;
+
+    // 选择最小的预分频，使长周期（base+1个计数）不超过256。
+    // 各时钟模式下都能找到（sys_timer.h按HSE_VALUE编译期检查）
+    while (shift < 7 && ((cycles + (1UL << shift) - 1) >> shift) > 256)
+    {
+        shift++;
+    }
+
+    istate = __get_interrupt_state();
+    __disable_interrupt();
+    sys_timer_shift = shift;
+    sys_timer_base = (uint8_t)((cycles >> shift) - 1);
+    sys_timer_frac = (uint8_t)(cycles & ((1U << shift) - 1));
+    sys_timer_acc = 0;
+    TIM4->PSCR = shift;
+    TIM4->ARR = sys_timer_base;
+    TIM4->EGR = TIM4_EGR_UG;            // 立即加载预分频和周期
+    TIM4->SR1 = (uint8_t)(~TIM4_SR1_UIF); // UG产生的更新不计为tick
+
+    if (sys_timer_mhz != 0)
+    {
+        count = sys_timer_cnt3_read(&base, &rem, &high);
+        sys_us_base = base + ((uint32_t)count + rem) / sys_timer_mhz;
+        sys_cycles_high = high + 1; // 周期计数保持递增，跨越切换的差值没有意义
+    }
+    sys_us_rem = 0;
+    sys_timer_mhz = mhz;
+    sys_ovf_us = (uint16_t)(65536UL / mhz);
+    sys_ovf_rem = (uint8_t)(65536UL % mhz);
+    TIM3->EGR = TIM3_EGR_UG;              // 计数清0
+    TIM3->SR1 = (uint8_t)(~TIM3_SR1_UIF); // UG产生的更新不计为溢出
+    __set_interrupt_state(istate);
+}
 
 void sys_timer_init(void)
 {
-    TIM4_TimeBaseInit(TIM4_PRESCALER_128, 125); // 初始化定时器4,1MS一次中断
+    bsp_clk_request(CLK_PERIPHERAL_TIMER4);
+    bsp_clk_request(CLK_PERIPHERAL_TIMER3);
+    TIM3->PSCR = 0;                             // TIM3不分频，计数0..0xFFFF
+    TIM3->ARRH = 0xFF;
+    TIM3->ARRL = 0xFF;
+    TIM3->IER = TIM3_IER_UIE;
+    TIM3->CR1 = TIM3_CR1_CEN;
     TIM4_ARRPreloadConfig(ENABLE);              // 使能自动重装
+    sys_timer_set_fmaster(CLK_GetClockFreq());  // 计数0..ARR，每SYS_TICK_HZ中断一次
     TIM4_ITConfig(TIM4_IT_UPDATE, ENABLE);      // 数据更新中断
     TIM4_Cmd(ENABLE);                           // 开定时器
 }
 
-void sys_timer_update_handler(void)
+// 主时钟切换通知，切换后重新计算时基
+void sys_timer_clk_notify(bsp_clk_event_t event, uint32_t fmaster)
+{
+    if (event == BSP_CLK_EVT_POST)
+    {
+        sys_timer_set_fmaster(fmaster);
+    }
+}
+
+// 当前主时钟MHz数（sys_timer_get_cycles每微秒的计数），系统定时器启动之前为0
+uint8_t sys_timer_get_mhz(void)
+{
+    return sys_timer_mhz;
+}
+
+// sys_timer_get_cycles的分辨率（纳秒，即一个主时钟周期，取整）
+uint16_t sys_timer_get_resolution_ns(void)
+{
+    return (uint16_t)(1000U / sys_timer_mhz);
+}
+
+// tick中断：TIM4只有UIF一个中断源，不再检查标志，直接写0清除（写1无效）。
+// 周期不是整数个计数时按累加的余数选择下一个周期（ARR预装载，下一次更新时生效）
+INTERRUPT_HANDLER(TIM4_UPD_OVF_IRQHandler, 23)
 {
-    // Check update interrupt flag
-    if (TIM4_GetITStatus(TIM4_IT_UPDATE) != RESET)
+    TIM4->SR1 = (uint8_t)(~TIM4_SR1_UIF);
+    sys_ticks++;
+    if (sys_timer_frac != 0)
     {
-        // 10ms callback processing
-        system_ticks++;
-        system_time_ms++;
-        count_1000_tick++;
-        if (count_1000_tick == 1000)
+        sys_timer_acc += sys_timer_frac;
+        if (sys_timer_acc >= (uint8_t)(1U << sys_timer_shift))
+        {
+            sys_timer_acc -= (uint8_t)(1U << sys_timer_shift);
+            TIM4->ARR = sys_timer_base + 1;
+        }
+        else
         {
-            count_1000_tick = 0;
-            system_time_s++;
+            TIM4->ARR = sys_timer_base;
         }
-        TIM4_ClearITPendingBit(TIM4_IT_UPDATE);
     }
 }
 
+// TIM3溢出：累加65536个周期对应的微秒数，不足1us的部分累计进位
+INTERRUPT_HANDLER(TIM3_UPD_OVF_BRK_IRQHandler, 15)
+{
+    uint8_t rem;
+
+    TIM3->SR1 = (uint8_t)(~TIM3_SR1_UIF); // 只写0清除UIF，捕获标志写1无影响
+    sys_cycles_high++;
+    rem = sys_us_rem + sys_ovf_rem;
+    if (rem >= sys_timer_mhz)
+    {
+        rem -= sys_timer_mhz;
+        sys_us_base++;
+    }
+    sys_us_rem = rem;
+    sys_us_base += sys_ovf_us;
+}
+
+// 读取定时器中断更新的32位计数。STM8按字节读取，中断发生在字节之间会读到新旧混合的值，
+// 连续读两次直到相同：两次之间最多发生一次中断（间隔至少100us），结果不同说明其中一次被打断。
+// 不需要关中断，在中断中调用时不会被tick打断，第一次即返回
+uint32_t sys_timer_get_ticks(void)
+{
+    uint32_t value;
+
+    do
+    {
+        value = sys_ticks;
+    } while (value != sys_ticks);
+    return value;
+}
+
 // 获取系统时间 (毫秒)
 uint32_t sys_timer_get_system_time_ms(void)
 {
-    return system_time_ms;
+    return SYS_TICKS_TO_MS(sys_timer_get_ticks());
 }
 
 // 获取系统时间 (秒)
 uint32_t sys_timer_get_system_time_sec(void)
 {
-    return system_time_s;
+    return sys_timer_get_ticks() / SYS_TICK_HZ;
+}
+
+// 获取微秒时间戳（约71分钟回绕），由TIM3溢出累计的微秒数和TIM3当前计数组合，精确到1us。
+// 短暂关中断保证两者来自同一时刻，可在中断中调用
+uint32_t sys_timer_get_us(void)
+{
+    uint32_t base;
+    uint16_t rem;
+    uint16_t high;
+    uint16_t count;
+    __istate_t istate;
+
+    istate = __get_interrupt_state();
+    __disable_interrupt();
+    count = sys_timer_cnt3_read(&base, &rem, &high);
+    __set_interrupt_state(istate);
+    return base + ((uint32_t)count + rem) / sys_timer_mhz;
+}
+
+// 获取主时钟周期计数（32位，16MHz下约268秒回绕），分辨率一个主时钟周期（16MHz下62.5ns），
+// 用于亚微秒级的短间隔测量，差值除以主时钟MHz数即为微秒。时钟切换后重新计数，
+// 跨越切换或主动停机的差值没有意义
+uint32_t sys_timer_get_cycles(void)
+{
+    uint32_t base;
+    uint16_t rem;
+    uint16_t high;
+    uint16_t count;
+    __istate_t istate;
+
+    istate = __get_interrupt_state();
+    __disable_interrupt();
+    count = sys_timer_cnt3_read(&base, &rem, &high);
+    __set_interrupt_state(istate);
+    return ((uint32_t)high << 16) | count;
+}
+
+// 补偿停机期间TIM4/TIM3停止计数的时间，不足1个tick的部分累计到下次
+void sys_timer_add_us(uint32_t us)
+{
+    static uint16_t remain = 0;
+    uint32_t total = us + remain;
+    __istate_t istate = __get_interrupt_state();
+
+    __disable_interrupt();
+    sys_ticks += total / SYS_TICK_US;
+    sys_us_base += us;
+    __set_interrupt_state(istate);
+    remain = (uint16_t)(total % SYS_TICK_US);
+}
+
+static void sys_isr_cost_add(sys_isr_cost_t *cost, uint16_t cycles)
+{
+    if (cost->count == 0 || cycles < cost->min)
+    {
+        cost->min = cycles;
+    }
+    if (cycles > cost->max)
+    {
+        cost->max = cycles;
+    }
+    cost->sum += cycles;
+    cost->count++;
+}
+
+// 读取TIM3计数及同一时刻tick计数的低字节，中断发生在读取之间时返回FALSE
+static bool sys_timer_isr_probe(uint16_t *count, uint8_t *tick)
+{
+    uint8_t byte;
+
+    *tick = (uint8_t)sys_ticks;
+    byte = TIM3->CNTRH;
+    *count = ((uint16_t)byte << 8) | TIM3->CNTRL;
+    return (*tick == (uint8_t)sys_ticks) ? TRUE : FALSE;
+}
+
+// 测量tick中断和TIM3溢出中断的开销：循环读取TIM3计数，相邻两次读取的间隔减去没有中断时的最小间隔
+// 即为期间中断占用的周期数。间隔内tick变化且计数未回绕的计入tick中断，计数回绕且tick未变化的计入
+// 溢出中断，中断发生在读取之间或两种中断同时发生的丢弃。其他中断（如串口）也会计入，
+// 测量前应等待串口发送完毕。需开中断调用，tick中断达到samples次时返回
+void sys_timer_measure_isr(sys_isr_cost_t *tick, sys_isr_cost_t *ovf, uint16_t samples)
+{
+    uint16_t prev = 0;
+    uint16_t count;
+    uint16_t delta;
+    uint16_t idle = 0xFFFF; // 没有中断时两次读取的最小间隔
+    uint8_t prev_tick = 0;
+    uint8_t now_tick;
+    bool valid = FALSE;     // prev是否可用
+    bool wrapped;
+
+    tick->count = 0;
+    tick->sum = 0;
+    tick->max = 0;
+    ovf->count = 0;
+    ovf->sum = 0;
+    ovf->max = 0;
+    if ((__get_interrupt_state() & CPU_CC_I1I0) == CPU_CC_I1I0)
+    {
+        return;
+    }
+    while (tick->count < samples)
+    {
+        if (!sys_timer_isr_probe(&count, &now_tick))
+        {
+            valid = FALSE;
+            continue;
+        }
+        if (valid)
+        {
+            delta = count - prev;
+            wrapped = (count < prev) ? TRUE : FALSE;
+            if (now_tick == prev_tick && !wrapped)
+            {
+                if (delta < idle)
+                {
+                    idle = delta;
+                }
+            }
+            else if (idle != 0xFFFF && delta >= idle)
+            {
+                if (now_tick != prev_tick && !wrapped)
+                {
+                    sys_isr_cost_add(tick, delta - idle);
+                }
+                else if (now_tick == prev_tick && wrapped)
+                {
+                    sys_isr_cost_add(ovf, delta - idle);
+                }
+            }
+        }
+        prev = count;
+        prev_tick = now_tick;
+        valid = TRUE;
+    }
+}
+
+// 开始计时，ms毫秒后sys_timeout_expired返回TRUE
+void sys_timeout_start(sys_timeout_t *timeout, uint32_t ms)
+{
+    timeout->start = sys_timer_get_ticks();
+    timeout->duration = SYS_MS_TO_TICKS(ms);
+}
+
+// 是否已超时，按tick差值比较，计数回绕时仍然正确
+bool sys_timeout_expired(const sys_timeout_t *timeout)
+{
+    return (sys_timer_get_ticks() - timeout->start >= timeout->duration) ? TRUE : FALSE;
+}
+
+// 周期性执行：到达*next（tick计数）时返回TRUE并把*next推进一个周期（以上次的到期时间为基准，不累积误差），
+// 落后超过一个周期时从当前时间重新开始。*next初值为0时立即到期
+bool sys_delay_until(uint32_t *next, uint32_t period_ms)
+{
+    uint32_t now = sys_timer_get_ticks();
+    uint32_t period = SYS_MS_TO_TICKS(period_ms);
+
+    if ((int32_t)(now - *next) < 0)
+    {
+        return FALSE;
+    }
+    *next += period;
+    if ((int32_t)(now - *next) >= 0)
+    {
+        *next = now + period;
+    }
+    return TRUE;
 }
@@ -1,10 +1,71 @@
 #ifndef SYS_TIMER_H
 #define SYS_TIMER_H
 
+// 系统tick频率（Hz），1000以下须能整除1000，1000以上须为1000的倍数，最高主时钟下一个tick
+// 不超过TIM4的256×128个计数（HSE 24MHz时不低于733Hz，即1000~10000Hz；只用HSI时不低于489Hz）。
+// TIM4的预分频和周期在运行时按主时钟计算，周期不是整数个计数时交替使用相邻的两个周期，平均tick长度准确
+#define SYS_TICK_HZ             1000
+#define SYS_TIMER_FMASTER_HZ    16000000UL // 上电主时钟（HSI），用于编译期检查
+
+#if SYS_TICK_HZ > 10000
+#error "SYS_TICK_HZ above 10kHz, tick interrupt would dominate CPU time"
+#endif
+#if (SYS_TICK_HZ <= 1000 && 1000 % SYS_TICK_HZ != 0) || (SYS_TICK_HZ > 1000 && SYS_TICK_HZ % 1000 != 0)
+#error "SYS_TICK_HZ must divide 1000 or be a multiple of 1000"
+#endif
+#if SYS_TIMER_FMASTER_HZ % SYS_TICK_HZ != 0
+#error "SYS_TICK_HZ must divide the master clock"
+#endif
+
+// 上电时钟下每个tick的主时钟周期数，TIM4最大预分频128、周期256个计数。
+// 切换到HSE模式（HSE_VALUE）时的检查见sys_timer.c（HSE_VALUE带类型转换，不能用于#if）
+#define SYS_TICK_CYCLES         (SYS_TIMER_FMASTER_HZ / SYS_TICK_HZ)
+#define SYS_TICK_CYCLES_MAX     (256UL * 128)
+#if SYS_TICK_CYCLES > SYS_TICK_CYCLES_MAX
+#error "SYS_TICK_HZ too low for the 8-bit TIM4"
+#endif
+
+// tick与时间换算，毫秒换算为tick时向上取整（至少经过指定时间）
+#define SYS_TICK_US             (1000000UL / SYS_TICK_HZ)
+#if SYS_TICK_HZ <= 1000
+#define SYS_TICKS_TO_MS(ticks)  ((uint32_t)(ticks) * (1000 / SYS_TICK_HZ))
+#else
+#define SYS_TICKS_TO_MS(ticks)  ((uint32_t)(ticks) / (SYS_TICK_HZ / 1000))
+#endif
+#define SYS_MS_TO_TICKS(ms)     (((uint32_t)(ms) * SYS_TICK_HZ + 999) / 1000)
+
+// 超时对象，用于按调度周期返回的任务中非阻塞地等待
+typedef struct
+{
+    uint32_t start;     // tick
+    uint32_t duration;  // tick
+} sys_timeout_t;
+
+// 中断开销测量结果（主时钟周期，含硬件进入/退出）
+typedef struct
+{
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+    uint16_t count;
+} sys_isr_cost_t;
+
 void sys_timer_init(void);
-void sys_timer_update_handler(void);
-uint32_t sys_timer_get_tick_ms(void);
+void sys_timer_clk_notify(bsp_clk_event_t event, uint32_t fmaster);
+uint8_t sys_timer_get_mhz(void);
+uint16_t sys_timer_get_resolution_ns(void);
+// tick计数，比较时间间隔应使用tick（差值在计数回绕时仍然正确）。
+// SYS_TICK_HZ大于1000时毫秒时间由tick相除得到，tick回绕时（10kHz下约5天）毫秒时间不连续
+uint32_t sys_timer_get_ticks(void);
 uint32_t sys_timer_get_system_time_sec(void);
 uint32_t sys_timer_get_system_time_ms(void);
+uint32_t sys_timer_get_us(void);
+uint32_t sys_timer_get_cycles(void);
+void sys_timer_add_us(uint32_t us);
+void sys_timer_measure_isr(sys_isr_cost_t *tick, sys_isr_cost_t *ovf, uint16_t samples);
+
+void sys_timeout_start(sys_timeout_t *timeout, uint32_t ms);
+bool sys_timeout_expired(const sys_timeout_t *timeout);
+bool sys_delay_until(uint32_t *next, uint32_t period_ms);
 
 #endif
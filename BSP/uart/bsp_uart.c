@@ -1,57 +1,949 @@
 #include "bsp_uart.h"
-#include "stm8s_uart1.h"
+#include "bsp_log.h"
+#include "sys_timer.h"
 
-// UART接收回调函数指针
-static void (*uart_rx_callback)(uint8_t data) = NULL;
+#define UART_TX_BUF_MASK (UART_TX_BUF_SIZE - 1)
+#define UART_RX_BUF_MASK (UART_RX_BUF_SIZE - 1)
+#define UART_FRAME_QUEUE_MASK (UART_FRAME_QUEUE_SIZE - 1)
 
-// UART硬件初始化
-void uart_hw_init(u32 baudrate)
+// 接收错误标志（SR中与接收字节同时置位的位）
+#define UART_SR_RX_ERR   (UART1_SR_OR | UART1_SR_NF | UART1_SR_FE | UART1_SR_PE)
+
+// UART1与UART3前8个寄存器布局和位定义相同，驱动只访问这部分
+typedef struct
+{
+    __IO uint8_t SR;
+    __IO uint8_t DR;
+    __IO uint8_t BRR1;
+    __IO uint8_t BRR2;
+    __IO uint8_t CR1;
+    __IO uint8_t CR2;
+    __IO uint8_t CR3;
+    __IO uint8_t CR4;
+} uart_regs_t;
+
+// 端口数据
+typedef struct
+{
+    uart_regs_t *regs;
+    CLK_Peripheral_TypeDef clk; // 外设时钟，uart_init时申请，uart_deinit时释放
+
+    // 自动波特率检测：RX引脚及其端口外部中断
+    GPIO_TypeDef *rx_gpio;
+    uint8_t rx_pin;
+    uint8_t exti_mask;          // EXTI_CR1中该端口的灵敏度位
+    volatile uint8_t autobaud;  // uart_autobaud_state_t
+    uint8_t ab_count;           // 已记录的下降沿个数
+    uint16_t ab_stamp[UART_AUTOBAUD_EDGES]; // 各下降沿的TIM2计数
+    sys_timeout_t ab_timeout;   // 检测超时，到期后结束检测
+
+    bool opened;
+
+    // 低功耗：接收中断只置标志，查询时换算为时间
+    volatile bool rx_seen;
+    uint32_t rx_last;           // 最后一次接收的tick
+
+    // 接收环形缓冲区，单生产者（接收中断）单消费者，head只由中断修改，tail只由读取方修改，
+    // 8位下标的读写是原子的，不需要关中断
+    uint8_t rx_buf[UART_RX_BUF_SIZE];
+    volatile uint8_t rx_head;
+    volatile uint8_t rx_tail;
+    uart_rx_notify_t notify;    // 接收事件通知函数
+    uint8_t threshold;          // 缓冲数据量达到该值时通知，0表示不通知
+
+    // 帧接收模式：线路空闲时把当前帧在接收缓冲区中的位置放入帧队列，帧数据不复制
+    struct
+    {
+        uint8_t start;
+        uint8_t len;
+        uint8_t flags;
+    } frames[UART_FRAME_QUEUE_SIZE];
+    volatile uint8_t frame_head;
+    volatile uint8_t frame_tail;
+    uint8_t frame_start;        // 正在接收的帧的起始位置
+    uint8_t frame_flags;        // 正在接收的帧的错误标志
+    bool framed;                // 是否处于帧接收模式
+
+    // 发送环形缓冲区，head只由写入方修改，tail只由发送中断修改（满时覆盖策略例外，此时已屏蔽发送中断）
+    uint8_t tx_buf[UART_TX_BUF_SIZE];
+    volatile uint8_t tx_head;
+    volatile uint8_t tx_tail;
+    uart_tx_policy_t policy;    // 发送缓冲区满时的处理策略
+
+    // RS-485收发控制
+    GPIO_TypeDef *de_gpio;      // DE/RE控制引脚端口，NULL表示未启用
+    uint8_t de_pin;
+    uint32_t de_start;          // 最后一个字节进入移位寄存器时的sys_timer_get_us时间戳
+    uint16_t char_us;           // 一个字符（起始位+数据位+校验位+停止位）的时间，设置波特率时更新
+
+    uart_stats_t stats;
+} uart_dev_t;
+
+// 端口表，中断向量：UART1 TX/RX 17/18，UART3 TX/RX 20/21，
+// RX引脚PA4/PD6的端口外部中断（自动波特率）3/6
+static uart_dev_t uart_devs[UART_PORT_NUM] = {
+    {.regs = (uart_regs_t *)UART1_BaseAddress, .clk = CLK_PERIPHERAL_UART1,
+     .rx_gpio = GPIOA, .rx_pin = GPIO_PIN_4, .exti_mask = EXTI_CR1_PAIS, .autobaud = UART_AUTOBAUD_OFF},
+    {.regs = (uart_regs_t *)UART3_BaseAddress, .clk = CLK_PERIPHERAL_UART3,
+     .rx_gpio = GPIOD, .rx_pin = GPIO_PIN_6, .exti_mask = EXTI_CR1_PDIS, .autobaud = UART_AUTOBAUD_OFF},
+};
+
+// 标准输出重定向函数指针，为NULL时printf直接输出到控制台端口
+static void (*uart_stdout_hook)(const uint8_t *data, uint16_t len) = NULL;
+
+// 屏蔽/恢复发送中断，用于与发送中断互斥（不影响其他中断）
+#define UART_TX_IT_DISABLE(dev) ((dev)->regs->CR2 &= (uint8_t)(~UART1_CR2_TIEN))
+#define UART_TX_IT_ENABLE(dev)  ((dev)->regs->CR2 |= UART1_CR2_TIEN)
+
+static void uart_autobaud_end(uart_dev_t *dev, uart_autobaud_state_t state);
+
+/////////////////////////////端口操作/////////////////////////////
+
+// 标准波特率分频表，编译期生成
+typedef struct
+{
+    uint32_t baudrate;
+    uint8_t brr1;
+    uint8_t brr2;
+} uart_baud_entry_t;
+
+#define UART_BAUD_ENTRY(baud) \
+    {baud, UART_BRR1(UART_BRR_DIV(UART_FMASTER_HZ, baud)), UART_BRR2(UART_BRR_DIV(UART_FMASTER_HZ, baud))},
+static const uart_baud_entry_t uart_baud_table[] = {UART_BAUD_TABLE(UART_BAUD_ENTRY)};
+
+// 编译期检查每个表项：分频值在16..0xFFFF内，实际波特率误差不超过2%
+#define UART_BAUD_CHECK(baud)                                                              \
+    typedef char uart_baud_check_##baud[(UART_BRR_DIV(UART_FMASTER_HZ, baud) >= 16 &&     \
+                                         UART_BRR_DIV(UART_FMASTER_HZ, baud) <= 0xFFFF && \
+                                         UART_FMASTER_HZ / UART_BRR_DIV(UART_FMASTER_HZ, baud) * 50 >= (baud) * 49UL && \
+                                         UART_FMASTER_HZ / UART_BRR_DIV(UART_FMASTER_HZ, baud) * 50 <= (baud) * 51UL) ? 1 : -1];
+UART_BAUD_TABLE(UART_BAUD_CHECK)
+
+// 当前主时钟频率，初始化时读取一次，时钟切换后由uart_set_fmaster更新
+static uint32_t uart_fmaster = 0;
+
+// 主时钟频率变化后调用（之后需重新设置各端口波特率）
+void uart_set_fmaster(uint32_t fmaster)
 {
-    // 配置串口参数为：波特率115200，8位数据位，1位停止位，无校验，禁止同步传输，允许接收发送
-    UART1_Init(baudrate, UART1_WORDLENGTH_8D, UART1_STOPBITS_1, UART1_PARITY_NO, UART1_SYNCMODE_CLOCK_DISABLE, UART1_MODE_TXRX_ENABLE);
-    UART1_ITConfig(UART1_IT_RXNE_OR, ENABLE); // 使能接收中断
-    UART1_Cmd(ENABLE);                        // 使能UART1
+    uart_fmaster = fmaster;
 }
 
-// 设置UART接收回调函数
-void uart_set_rx_callback(void (*rx_callback)(uint8_t data))
+// 时钟切换通知：切换前等待已启用端口发送完毕，切换后按新主时钟换算分频值，保持原波特率
+// （包括自动波特率检测得到的非标准值）
+void uart_clk_notify(bsp_clk_event_t event, uint32_t fmaster)
 {
-    uart_rx_callback = rx_callback;
+    uint32_t baudrate[UART_PORT_NUM];
+    uint8_t i;
+
+    for (i = 0; i < UART_PORT_NUM; i++)
+    {
+        baudrate[i] = uart_get_baudrate((uart_port_t)i);
+        if (event == BSP_CLK_EVT_PRE && baudrate[i] != 0)
+        {
+            uart_tx_flush((uart_port_t)i);
+        }
+    }
+    if (event != BSP_CLK_EVT_POST)
+    {
+        return;
+    }
+    uart_fmaster = fmaster;
+    for (i = 0; i < UART_PORT_NUM; i++)
+    {
+        if (baudrate[i] != 0)
+        {
+            uart_set_baudrate((uart_port_t)i, baudrate[i]);
+        }
+    }
 }
 
-// UART发送字节
-void uart_send_byte(uint8_t data)
+// 低功耗钩子：有数据待发送、接收数据未读取、正在检测波特率或UART_PWR_RX_HOLD_MS内有接收时不允许停机。
+// 自动波特率检测超过UART_AUTOBAUD_TIMEOUT_MS时在这里结束（查询时已关中断，不会与边沿中断冲突），
+// 一直没有输入的端口不会阻止停机，也不再占用TIM2。
+// 停机前使能已打开端口RX引脚的下降沿中断用于唤醒（中断处理在自动波特率未开启时直接返回）
+bool uart_pwr_hook(bsp_pwr_event_t event)
 {
-    UART1_SendData8(data); // UART1发送8位数据
-    while (UART1_GetFlagStatus(UART1_FLAG_TXE) == RESET)
-        ; // 等待发送完成
+    uart_dev_t *dev;
+    uint32_t now = sys_timer_get_ticks();
+    uint8_t i;
+
+    for (i = 0; i < UART_PORT_NUM; i++)
+    {
+        dev = &uart_devs[i];
+        if (!dev->opened)
+        {
+            continue;
+        }
+        if (event == BSP_PWR_EVT_CHECK)
+        {
+            if (dev->rx_seen)
+            {
+                dev->rx_seen = FALSE;
+                dev->rx_last = now;
+            }
+            if (dev->autobaud == UART_AUTOBAUD_WAIT && sys_timeout_expired(&dev->ab_timeout))
+            {
+                uart_autobaud_end(dev, UART_AUTOBAUD_OFF); // 保持原波特率
+            }
+            if (dev->tx_head != dev->tx_tail || !(dev->regs->SR & UART1_SR_TC) ||
+                dev->rx_head != dev->rx_tail || dev->autobaud == UART_AUTOBAUD_WAIT ||
+                now - dev->rx_last < SYS_MS_TO_TICKS(UART_PWR_RX_HOLD_MS))
+            {
+                return TRUE;
+            }
+        }
+        else if (event == BSP_PWR_EVT_ENTER)
+        {
+            // 停机前已关中断，可以修改EXTI_CR1
+            EXTI->CR1 = (uint8_t)((EXTI->CR1 & (uint8_t)(~dev->exti_mask)) | (dev->exti_mask & 0xAA));
+            dev->rx_gpio->CR2 |= dev->rx_pin;
+        }
+        else
+        {
+            dev->rx_gpio->CR2 &= (uint8_t)(~dev->rx_pin);
+        }
+    }
+    return FALSE;
 }
 
-// UART发送字节数组
-void uart_send_bytes(const uint8_t *data, uint16_t len)
+// 按当前波特率和帧格式更新字符时间，用于从RS-485转换时间中扣除最后一个字符的发送时间
+static void uart_update_char_time(uart_port_t port)
 {
-    for (uint16_t i = 0; i < len; i++)
+    uart_dev_t *dev = &uart_devs[port];
+    uint32_t baudrate = uart_get_baudrate(port);
+    uint8_t bits = 10; // 起始位+8位数据+1位停止位
+
+    if (dev->regs->CR1 & UART1_CR1_M)
     {
-        uart_send_byte(data[i]);
+        bits++;
     }
+    if (dev->regs->CR3 & UART_STOPBITS_2)
+    {
+        bits++;
+    }
+    dev->char_us = baudrate == 0 ? 0 : (uint16_t)((bits * 1000000UL + baudrate / 2) / baudrate);
 }
 
-// UART1接收中断服务程序
-INTERRUPT_HANDLER(UART1_RX_IRQHandler, 18)
+// 直接写入分频值，BRR2必须先于BRR1写入（写BRR1时更新波特率）
+void uart_set_divider(uart_port_t port, uint16_t div)
+{
+    uart_regs_t *regs = uart_devs[port].regs;
+
+    regs->BRR2 = UART_BRR2(div);
+    regs->BRR1 = UART_BRR1(div);
+    uart_update_char_time(port);
+}
+
+// 设置波特率，主时钟为UART_FMASTER_HZ时查表，否则计算分频值
+void uart_set_baudrate(uart_port_t port, uint32_t baudrate)
+{
+    uart_regs_t *regs = uart_devs[port].regs;
+    uint8_t i;
+
+    if (uart_fmaster == 0)
+    {
+        uart_fmaster = CLK_GetClockFreq();
+    }
+    if (uart_fmaster == UART_FMASTER_HZ)
+    {
+        for (i = 0; i < sizeof(uart_baud_table) / sizeof(uart_baud_table[0]); i++)
+        {
+            if (uart_baud_table[i].baudrate == baudrate)
+            {
+                regs->BRR2 = uart_baud_table[i].brr2;
+                regs->BRR1 = uart_baud_table[i].brr1;
+                uart_update_char_time(port);
+                return;
+            }
+        }
+    }
+    uart_set_divider(port, (uint16_t)UART_BRR_DIV(uart_fmaster, baudrate));
+}
+
+// 当前实际波特率，由BRR寄存器中的分频值计算（自动波特率检测后可能不是标准值）
+uint32_t uart_get_baudrate(uart_port_t port)
+{
+    uart_regs_t *regs = uart_devs[port].regs;
+    uint8_t brr2;
+    uint16_t div;
+
+    if (!uart_devs[port].opened)
+    {
+        return 0; // 未打开的端口没有时钟，寄存器不可访问
+    }
+    brr2 = regs->BRR2;
+    div = ((uint16_t)(brr2 & 0xF0) << 8) | ((uint16_t)regs->BRR1 << 4) | (brr2 & 0x0F);
+
+    if (uart_fmaster == 0)
+    {
+        uart_fmaster = CLK_GetClockFreq();
+    }
+    return div == 0 ? 0 : (uart_fmaster + div / 2) / div;
+}
+
+// 相邻下降沿间隔的上限（TIM2计数），超过时认为是新的字符，开始检测时按主时钟计算
+static uint16_t uart_autobaud_gap_max;
+
+// 开启自动波特率检测：TIM2以主时钟自由运行作为边沿时间戳，RX引脚下降沿触发外部中断。
+// 每个检测中的端口持有一次TIM2时钟。修改EXTI_CR1需要关闭总中断，之后总中断保持打开，不能在中断中调用
+void uart_autobaud_start(uart_port_t port)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    if (dev->autobaud != UART_AUTOBAUD_WAIT)
+    {
+        bsp_clk_request(CLK_PERIPHERAL_TIMER2);
+    }
+    TIM2->PSCR = 0;
+    TIM2->ARRH = 0xFF;
+    TIM2->ARRL = 0xFF;
+    TIM2->EGR = TIM2_EGR_UG; // 预分频值在更新事件时生效
+    TIM2->CR1 |= TIM2_CR1_CEN;
+
+    if (uart_fmaster == 0)
+    {
+        uart_fmaster = CLK_GetClockFreq();
+    }
+    // 最低波特率下2个位时间再留1/2余量
+    uart_autobaud_gap_max = (uint16_t)(uart_fmaster / UART_AUTOBAUD_MIN_BAUD * 5 / 2);
+    dev->ab_count = 0;
+    sys_timeout_start(&dev->ab_timeout, UART_AUTOBAUD_TIMEOUT_MS);
+    dev->autobaud = UART_AUTOBAUD_WAIT;
+    disableInterrupts();
+    // 每个端口2位灵敏度，10为仅下降沿
+    EXTI->CR1 = (uint8_t)((EXTI->CR1 & (uint8_t)(~dev->exti_mask)) | (dev->exti_mask & 0xAA));
+    enableInterrupts();
+    dev->rx_gpio->CR2 |= dev->rx_pin;
+}
+
+// 结束自动波特率检测，没有端口在检测时停止TIM2，并释放该端口持有的TIM2时钟
+static void uart_autobaud_end(uart_dev_t *dev, uart_autobaud_state_t state)
+{
+    uint8_t i;
+
+    dev->rx_gpio->CR2 &= (uint8_t)(~dev->rx_pin);
+    dev->autobaud = state;
+    for (i = 0; i < UART_PORT_NUM; i++)
+    {
+        if (uart_devs[i].autobaud == UART_AUTOBAUD_WAIT)
+        {
+            break;
+        }
+    }
+    if (i == UART_PORT_NUM)
+    {
+        TIM2->CR1 &= (uint8_t)(~TIM2_CR1_CEN);
+    }
+    bsp_clk_release(CLK_PERIPHERAL_TIMER2);
+}
+
+// 取消自动波特率检测，保持当前波特率
+void uart_autobaud_stop(uart_port_t port)
+{
+    if (uart_devs[port].autobaud == UART_AUTOBAUD_WAIT)
+    {
+        uart_autobaud_end(&uart_devs[port], UART_AUTOBAUD_OFF);
+    }
+}
+
+// 自动波特率检测状态
+uart_autobaud_state_t uart_autobaud_state(uart_port_t port)
+{
+    return (uart_autobaud_state_t)uart_devs[port].autobaud;
+}
+
+// 端口初始化：申请外设时钟，设置帧格式、波特率，清空缓冲区，使能收发和接收中断
+void uart_init(uart_port_t port, const uart_config_t *config)
+{
+    uart_dev_t *dev = &uart_devs[port];
+    uart_regs_t *regs = dev->regs;
+
+    if (!dev->opened)
+    {
+        bsp_clk_request(dev->clk);
+        dev->opened = TRUE;
+    }
+    regs->CR2 = 0; // 先关闭收发和中断
+    regs->CR1 = config->word_length | config->parity;
+    regs->CR3 = (uint8_t)((regs->CR3 & (uint8_t)(~UART1_CR3_STOP)) | config->stop_bits);
+    uart_set_baudrate(port, config->baudrate);
+
+    dev->rx_head = 0;
+    dev->rx_tail = 0;
+    dev->tx_head = 0;
+    dev->tx_tail = 0;
+    dev->policy = UART_TX_POLICY_DEFAULT;
+
+    dev->frame_head = 0;
+    dev->frame_tail = 0;
+    dev->frame_start = 0;
+    dev->frame_flags = 0;
+
+    regs->CR2 = UART1_CR2_TEN | UART1_CR2_REN | UART1_CR2_RIEN |
+                ((dev->notify != NULL || dev->framed) ? UART1_CR2_ILIEN : 0);
+}
+
+// 关闭端口：结束自动波特率检测，发送完缓冲区中的数据后关闭收发和中断，释放外设时钟
+void uart_deinit(uart_port_t port)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    if (!dev->opened)
+    {
+        return;
+    }
+    uart_autobaud_stop(port);
+    uart_tx_flush(port);
+    dev->regs->CR2 = 0;
+    dev->opened = FALSE;
+    bsp_clk_release(dev->clk);
+}
+
+// 设置接收事件通知函数（在中断中调用），threshold为0时只通知空闲事件
+void uart_set_rx_notify(uart_port_t port, uart_rx_notify_t notify, uint8_t threshold)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    dev->regs->CR2 &= (uint8_t)(~UART1_CR2_ILIEN);
+    dev->notify = notify;
+    dev->threshold = threshold;
+    if (notify != NULL || dev->framed)
+    {
+        dev->regs->CR2 |= UART1_CR2_ILIEN; // 使能空闲中断
+    }
+}
+
+// 设置帧接收模式，开启后应使用uart_frame_get/uart_frame_release读取，不能再使用uart_read
+void uart_set_frame_mode(uart_port_t port, bool enable)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    dev->regs->CR2 &= (uint8_t)(~(UART1_CR2_RIEN | UART1_CR2_ILIEN));
+    dev->frame_head = 0;
+    dev->frame_tail = 0;
+    dev->frame_flags = 0;
+    dev->rx_tail = dev->rx_head; // 丢弃已接收的未成帧数据
+    dev->frame_start = dev->rx_head;
+    dev->framed = enable;
+    dev->regs->CR2 |= UART1_CR2_RIEN | ((enable || dev->notify != NULL) ? UART1_CR2_ILIEN : 0);
+}
+
+// 获取下一个完整帧，数据直接指向接收缓冲区，处理完后必须调用uart_frame_release
+bool uart_frame_get(uart_port_t port, uart_frame_t *frame)
+{
+    uart_dev_t *dev = &uart_devs[port];
+    uint8_t tail = dev->frame_tail;
+    uint8_t start;
+    uint8_t first;
+
+    if (tail == dev->frame_head)
+    {
+        return FALSE;
+    }
+    start = dev->frames[tail].start;
+    first = UART_RX_BUF_SIZE - start;
+    if (first > dev->frames[tail].len)
+    {
+        first = dev->frames[tail].len;
+    }
+    frame->data = &dev->rx_buf[start];
+    frame->len = first;
+    frame->wrap_data = dev->rx_buf; // 帧跨越缓冲区末尾时的第二段
+    frame->wrap_len = dev->frames[tail].len - first;
+    frame->flags = dev->frames[tail].flags;
+    return TRUE;
+}
+
+// 释放uart_frame_get取得的帧，其占用的接收缓冲区可以重新使用
+void uart_frame_release(uart_port_t port)
+{
+    uart_dev_t *dev = &uart_devs[port];
+    uint8_t tail = dev->frame_tail;
+
+    if (tail == dev->frame_head)
+    {
+        return;
+    }
+    dev->rx_tail = (dev->frames[tail].start + dev->frames[tail].len) & UART_RX_BUF_MASK;
+    dev->frame_tail = (tail + 1) & UART_FRAME_QUEUE_MASK;
+}
+
+// 从接收缓冲区读取最多len字节，返回实际读取的字节数
+uint8_t uart_read(uart_port_t port, uint8_t *buf, uint8_t len)
+{
+    uart_dev_t *dev = &uart_devs[port];
+    uint8_t tail = dev->rx_tail;
+    uint8_t head = dev->rx_head;
+    uint8_t n = 0;
+
+    while (n < len && tail != head)
+    {
+        buf[n++] = dev->rx_buf[tail];
+        tail = (tail + 1) & UART_RX_BUF_MASK;
+    }
+    dev->rx_tail = tail;
+    return n;
+}
+
+// 接收缓冲区中的字节数
+uint8_t uart_rx_count(uart_port_t port)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    return (uint8_t)((dev->rx_head - dev->rx_tail) & UART_RX_BUF_MASK);
+}
+
+// 查询方式发送一个字节，缓冲区满且全局中断被关闭时（如断言失败处理中）保证能继续发送
+static void uart_tx_poll(uart_dev_t *dev)
+{
+    UART_TX_IT_DISABLE(dev);
+    if ((dev->regs->SR & UART1_SR_TXE) && dev->tx_tail != dev->tx_head)
+    {
+        dev->regs->DR = dev->tx_buf[dev->tx_tail];
+        dev->tx_tail = (dev->tx_tail + 1) & UART_TX_BUF_MASK;
+    }
+    UART_TX_IT_ENABLE(dev);
+}
+
+// 写入一个字节到发送缓冲区
+static void uart_tx_put(uart_dev_t *dev, uint8_t data)
+{
+    uint8_t head = dev->tx_head;
+    uint8_t next = (head + 1) & UART_TX_BUF_MASK;
+    uint8_t used;
+
+    // RS-485：取消尚未执行的DE释放，并在发送前使能驱动器。上一帧（或复位后）残留的TC
+    // 由发送中断写DR时的读SR-写DR序列清除，不能软件写0，否则TC要等下一次发送结束才会再置位
+    if (dev->de_gpio != NULL)
+    {
+        dev->regs->CR2 &= (uint8_t)(~UART1_CR2_TCIEN);
+        dev->de_gpio->ODR |= dev->de_pin;
+    }
+
+    if (next == dev->tx_tail)
+    {
+        switch (dev->policy)
+        {
+        case UART_TX_DROP:
+            dev->stats.tx_dropped++;
+            return;
+
+        case UART_TX_OVERWRITE:
+            // 丢弃最旧的字节
+            UART_TX_IT_DISABLE(dev);
+            if (next == dev->tx_tail)
+            {
+                dev->tx_tail = (dev->tx_tail + 1) & UART_TX_BUF_MASK;
+                dev->stats.tx_dropped++;
+            }
+            break;
+
+        default: // UART_TX_BLOCK
+            dev->stats.tx_blocked++;
+            while (next == dev->tx_tail)
+            {
+                uart_tx_poll(dev);
+            }
+            break;
+        }
+    }
+
+    dev->tx_buf[head] = data;
+    dev->tx_head = next;
+
+    used = (next - dev->tx_tail) & UART_TX_BUF_MASK;
+    if (used > dev->stats.tx_high_water)
+    {
+        dev->stats.tx_high_water = used;
+    }
+    UART_TX_IT_ENABLE(dev);
+}
+
+// 写入发送缓冲区后立即返回，由发送中断发出
+void uart_write(uart_port_t port, const uint8_t *data, uint16_t len)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    while (len--)
+    {
+        uart_tx_put(dev, *data++);
+    }
+}
+
+// 发送缓冲区剩余空间
+uint8_t uart_tx_free(uart_port_t port)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    return (uint8_t)((dev->tx_tail - dev->tx_head - 1) & UART_TX_BUF_MASK);
+}
+
+// 等待缓冲区中的数据全部发送完成（修改波特率或进入低功耗前调用）
+void uart_tx_flush(uart_port_t port)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    while (dev->tx_tail != dev->tx_head)
+    {
+        uart_tx_poll(dev);
+    }
+    while ((dev->regs->SR & UART1_SR_TC) == 0)
+        ;
+}
+
+// 设置发送缓冲区满时的处理策略
+void uart_tx_set_policy(uart_port_t port, uart_tx_policy_t policy)
+{
+    uart_devs[port].policy = policy;
+}
+
+// 设置RS-485模式：发送期间由驱动将DE/RE引脚置高，最后一位发出后在发送完成中断中拉低，
+// gpio为NULL时关闭RS-485模式
+void uart_set_rs485(uart_port_t port, GPIO_TypeDef *gpio, GPIO_Pin_TypeDef pin)
+{
+    uart_dev_t *dev = &uart_devs[port];
+
+    uart_tx_flush(port);
+    dev->regs->CR2 &= (uint8_t)(~UART1_CR2_TCIEN);
+    if (dev->de_gpio != NULL)
+    {
+        dev->de_gpio->ODR &= (uint8_t)(~dev->de_pin);
+    }
+    dev->de_gpio = gpio;
+    dev->de_pin = (uint8_t)pin;
+    if (gpio != NULL)
+    {
+        GPIO_Init(gpio, pin, GPIO_MODE_OUT_PP_LOW_FAST); // 默认接收
+    }
+}
+
+// 获取端口统计
+void uart_get_stats(uart_port_t port, uart_stats_t *stats)
+{
+    *stats = uart_devs[port].stats;
+}
+
+/////////////////////////////中断/////////////////////////////
+
+// 发送完成，释放RS-485总线并记录转换延迟：从最后一个字节进入移位寄存器到释放DE的时间
+// 扣除该字符本身的发送时间，即最后一个停止位结束后DE仍保持使能的时间
+static void uart_tx_complete(uart_dev_t *dev)
+{
+    uint32_t elapsed;
+    uint16_t latency;
+
+    dev->de_gpio->ODR &= (uint8_t)(~dev->de_pin);
+    elapsed = sys_timer_get_us() - dev->de_start;
+    dev->regs->CR2 &= (uint8_t)(~UART1_CR2_TCIEN); // TC保持置位，uart_tx_flush和低功耗检查依赖它
+
+    // 时间戳分辨率内的误差可能使差值略小于字符时间
+    latency = elapsed > dev->char_us ? (uint16_t)(elapsed - dev->char_us) : 0;
+    dev->stats.rs485_frames++;
+    dev->stats.rs485_turnaround = latency;
+    if (latency > dev->stats.rs485_turnaround_max)
+    {
+        dev->stats.rs485_turnaround_max = latency;
+    }
+}
+
+// 发送中断处理（TXE和TC共用向量），发送寄存器空时从缓冲区取下一个字节
+static void uart_tx_isr(uart_dev_t *dev)
+{
+    uint8_t tail = dev->tx_tail;
+
+    if (tail != dev->tx_head)
+    {
+        (void)dev->regs->SR; // 读SR后写DR清除TC，RS-485模式等待的是这一帧的TC
+        dev->regs->DR = dev->tx_buf[tail];
+        tail = (tail + 1) & UART_TX_BUF_MASK;
+        dev->tx_tail = tail;
+        // 缓冲区已空，关闭发送中断，下次写入时再打开；
+        // RS-485模式需要等最后一个字节进入移位寄存器，再响应一次TXE
+        if (tail == dev->tx_head && dev->de_gpio == NULL)
+        {
+            UART_TX_IT_DISABLE(dev);
+        }
+        return;
+    }
+
+    UART_TX_IT_DISABLE(dev);
+    if (dev->de_gpio == NULL)
+    {
+        return;
+    }
+    if ((dev->regs->CR2 & UART1_CR2_TCIEN) == 0)
+    {
+        // 最后一个字节已进入移位寄存器，等待发送完成中断
+        dev->de_start = sys_timer_get_us();
+        dev->regs->CR2 |= UART1_CR2_TCIEN;
+    }
+    else if (dev->regs->SR & UART1_SR_TC)
+    {
+        uart_tx_complete(dev);
+    }
+}
+
+// 线路空闲，结束当前帧并放入帧队列，队列满时丢弃该帧
+static void uart_rx_frame_end(uart_dev_t *dev)
+{
+    uint8_t head = dev->frame_head;
+    uint8_t next = (head + 1) & UART_FRAME_QUEUE_MASK;
+    uint8_t len = (dev->rx_head - dev->frame_start) & UART_RX_BUF_MASK;
+
+    if (len == 0)
+    {
+        return;
+    }
+    if (next == dev->frame_tail)
+    {
+        dev->rx_head = dev->frame_start; // 接收中断是唯一的写入方，可以直接回退
+        dev->stats.rx_frames_dropped++;
+    }
+    else
+    {
+        dev->frames[head].start = dev->frame_start;
+        dev->frames[head].len = len;
+        dev->frames[head].flags = dev->frame_flags;
+        dev->frame_head = next;
+        dev->frame_start = dev->rx_head;
+        dev->stats.rx_frames++;
+    }
+    dev->frame_flags = 0;
+}
+
+// 接收中断处理，数据直接写入接收缓冲区，只在达到阈值或线路空闲时通知
+static void uart_rx_isr(uart_dev_t *dev)
+{
+    // 先读SR再读DR，同时清除RXNE、IDLE和错误标志
+    uint8_t sr = dev->regs->SR;
+    uint8_t data = dev->regs->DR;
+    uint8_t head = dev->rx_head;
+    uint8_t next = (head + 1) & UART_RX_BUF_MASK;
+
+    if (sr & UART_SR_RX_ERR)
+    {
+        if (sr & UART1_SR_OR)
+        {
+            dev->stats.rx_overrun++;
+        }
+        if (sr & UART1_SR_NF)
+        {
+            dev->stats.rx_noise++;
+        }
+        if (sr & UART1_SR_FE)
+        {
+            dev->stats.rx_framing++;
+        }
+        if (sr & UART1_SR_PE)
+        {
+            dev->stats.rx_parity++;
+        }
+        dev->frame_flags |= sr & UART_SR_RX_ERR;
+    }
+    if (sr & UART1_SR_RXNE)
+    {
+        if (dev->autobaud == UART_AUTOBAUD_WAIT && !(sr & UART_SR_RX_ERR))
+        {
+            uart_autobaud_end(dev, UART_AUTOBAUD_OFF); // 主机使用的就是当前波特率
+        }
+        dev->rx_seen = TRUE;
+        if (next != dev->rx_tail)
+        {
+            dev->rx_buf[head] = data;
+            dev->rx_head = next;
+            if (dev->notify != NULL &&
+                ((next - dev->rx_tail) & UART_RX_BUF_MASK) == dev->threshold)
+            {
+                dev->notify(UART_RX_EVT_THRESHOLD);
+            }
+        }
+        else
+        {
+            dev->stats.rx_dropped++;
+            dev->frame_flags |= UART_FRAME_ERR_TRUNC;
+        }
+    }
+    if (sr & UART1_SR_IDLE)
+    {
+        if (dev->framed)
+        {
+            uart_rx_frame_end(dev);
+        }
+        if (dev->notify != NULL)
+        {
+            dev->notify(UART_RX_EVT_IDLE);
+        }
+    }
+}
+
+// 由已记录的下降沿计算分频值，不是同步字符时返回0。
+// 0x55从起始位开始每2位一个下降沿，共5个，每个下降沿在各自的中断中记录时间戳，中断响应延迟相同，
+// 首尾跨度为8个位时间，位时间的主时钟周期数即为分频值。任一间隔偏离平均值超过1/8则认为不是同步字符
+// （被其他中断推迟的时间戳同样会被排除）
+static uint16_t uart_autobaud_calc(const uint16_t *stamp)
+{
+    uint16_t span;
+    uint16_t mean;
+    uint16_t interval;
+    uint16_t div;
+    uint16_t table_div;
+    uint8_t i;
+
+    span = stamp[UART_AUTOBAUD_EDGES - 1] - stamp[0];
+    mean = span / (UART_AUTOBAUD_EDGES - 1);
+    for (i = 0; i < UART_AUTOBAUD_EDGES - 1; i++)
+    {
+        interval = stamp[i + 1] - stamp[i];
+        if (interval > mean + mean / 8 || interval + mean / 8 < mean)
+        {
+            return 0;
+        }
+    }
+    div = (span + 4) / 8;
+    if (div < 16)
+    {
+        return 0;
+    }
+
+    // 接近标准波特率时使用分频表中的值，消除测量误差
+    if (uart_fmaster == UART_FMASTER_HZ)
+    {
+        for (i = 0; i < sizeof(uart_baud_table) / sizeof(uart_baud_table[0]); i++)
+        {
+            table_div = ((uint16_t)(uart_baud_table[i].brr2 & 0xF0) << 8) |
+                        ((uint16_t)uart_baud_table[i].brr1 << 4) | (uart_baud_table[i].brr2 & 0x0F);
+            if (div + table_div / 16 >= table_div && div <= table_div + table_div / 16)
+            {
+                return table_div;
+            }
+        }
+    }
+    return div;
+}
+
+// RX引脚下降沿中断处理：每次中断只记录一个时间戳，不在中断中等待。与上一个下降沿间隔过长时
+// 从当前下降沿重新开始；记录满后计算分频值，不符合时丢弃最早的一个继续滑动（主机连续发送的
+// 同步字符之间也是2个位时间）。成功后重新使能接收器，丢弃按原波特率接收到一半的字节
+static void uart_autobaud_isr(uart_dev_t *dev)
 {
-    // 检查接收中断标志
-    if (UART1_GetITStatus(UART1_IT_RXNE) != RESET)
+    uart_regs_t *regs = dev->regs;
+    uint8_t high = TIM2->CNTRH; // 先读高字节锁存低字节，尽早读取以减小延迟差异
+    uint16_t stamp = ((uint16_t)high << 8) | TIM2->CNTRL;
+    uint16_t div;
+    uint8_t i;
+
+    if (dev->autobaud != UART_AUTOBAUD_WAIT)
+    {
+        return;
+    }
+    if (dev->ab_count > 0 && (uint16_t)(stamp - dev->ab_stamp[dev->ab_count - 1]) > uart_autobaud_gap_max)
+    {
+        dev->ab_count = 0;
+    }
+    dev->ab_stamp[dev->ab_count++] = stamp;
+    if (dev->ab_count < UART_AUTOBAUD_EDGES)
     {
-        // 读取接收的数据
-        uint8_t data = UART1_ReceiveData8();
-        // 调用注册的接收回调函数
-        if (uart_rx_callback != NULL)
+        return;
+    }
+    div = uart_autobaud_calc(dev->ab_stamp);
+    if (div == 0)
+    {
+        for (i = 0; i < UART_AUTOBAUD_EDGES - 1; i++)
         {
-            uart_rx_callback(data);
+            dev->ab_stamp[i] = dev->ab_stamp[i + 1];
         }
-        // 清除中断标志
-        UART1_ClearITPendingBit(UART1_IT_RXNE);
+        dev->ab_count = UART_AUTOBAUD_EDGES - 1;
+        dev->stats.autobaud_miss++;
+        return;
+    }
+    regs->CR2 &= (uint8_t)(~UART1_CR2_REN);
+    regs->BRR2 = UART_BRR2(div);
+    regs->BRR1 = UART_BRR1(div);
+    uart_update_char_time((uart_port_t)(dev - uart_devs));
+    (void)regs->SR;
+    (void)regs->DR;
+    regs->CR2 |= UART1_CR2_REN;
+    uart_autobaud_end(dev, UART_AUTOBAUD_DONE);
+    BSP_LOG2(UART_AUTOBAUD, dev - uart_devs, div);
+}
+
+INTERRUPT_HANDLER(EXTI_PORTA_IRQHandler, 3)
+{
+    uart_autobaud_isr(&uart_devs[UART_PORT_1]);
+}
+
+INTERRUPT_HANDLER(EXTI_PORTD_IRQHandler, 6)
+{
+    uart_autobaud_isr(&uart_devs[UART_PORT_3]);
+}
+
+INTERRUPT_HANDLER(UART1_TX_IRQHandler, 17)
+{
+    uart_tx_isr(&uart_devs[UART_PORT_1]);
+}
+
+INTERRUPT_HANDLER(UART1_RX_IRQHandler, 18)
+{
+    uart_rx_isr(&uart_devs[UART_PORT_1]);
+}
+
+INTERRUPT_HANDLER(UART3_TX_IRQHandler, 20)
+{
+    uart_tx_isr(&uart_devs[UART_PORT_3]);
+}
+
+INTERRUPT_HANDLER(UART3_RX_IRQHandler, 21)
+{
+    uart_rx_isr(&uart_devs[UART_PORT_3]);
+}
+
+/////////////////////////////控制台/////////////////////////////
+
+// 控制台硬件初始化：8位数据位，1位停止位，无校验
+void uart_hw_init(u32 baudrate)
+{
+    uart_config_t config = {0, UART_WORDLENGTH_8D, UART_PARITY_NO, UART_STOPBITS_1};
+
+    config.baudrate = baudrate;
+    uart_init(UART_CONSOLE_PORT, &config);
+#if UART_CONSOLE_AUTOBAUD
+    uart_autobaud_start(UART_CONSOLE_PORT);
+#endif
+}
+
+// 控制台发送字节
+void uart_send_byte(uint8_t data)
+{
+    uart_tx_put(&uart_devs[UART_CONSOLE_PORT], data);
+}
+
+// 控制台发送字节数组
+void uart_send_bytes(const uint8_t *data, uint16_t len)
+{
+    uart_write(UART_CONSOLE_PORT, data, len);
+}
+
+// 设置标准输出重定向函数，传入NULL恢复输出到控制台端口
+void uart_set_stdout_hook(void (*hook)(const uint8_t *data, uint16_t len))
+{
+    uart_stdout_hook = hook;
+}
+
+// 获取当前的标准输出重定向函数
+void (*uart_get_stdout_hook(void))(const uint8_t *data, uint16_t len)
+{
+    return uart_stdout_hook;
+}
+
+// 写入标准输出，设置了重定向函数时交给重定向函数处理
+void uart_stdout_write(const uint8_t *data, uint16_t len)
+{
+    if (uart_stdout_hook != NULL)
+    {
+        uart_stdout_hook(data, len);
+        return;
     }
+    uart_send_bytes(data, len);
 }
 
 //////////////////////////printf//////////////////////////////
@@ -64,7 +956,10 @@ INTERRUPT_HANDLER(UART1_RX_IRQHandler, 18)
 
 PUTCHAR_PROTOTYPE
 {
+    uint8_t data = (uint8_t)ch;
+#ifndef __GNUC__
     (void)f;
-    uart_send_byte((uint8_t)ch);
+#endif
+    uart_stdout_write(&data, 1);
     return (ch);
 }
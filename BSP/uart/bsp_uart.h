@@ -3,10 +3,180 @@
 
 #include "stm8s.h"
 #include "stdio.h"
+#include "bsp_clk.h"
+#include "bsp_pwr.h"
 
+// 发送/接收缓冲区大小（每个端口），必须为2的幂且不超过256
+#define UART_TX_BUF_SIZE        128
+#define UART_RX_BUF_SIZE        128
+#define UART_TX_POLICY_DEFAULT  UART_TX_BLOCK
+
+#if (UART_TX_BUF_SIZE & (UART_TX_BUF_SIZE - 1)) != 0 || UART_TX_BUF_SIZE > 256
+#error "UART_TX_BUF_SIZE must be a power of two not larger than 256"
+#endif
+#if (UART_RX_BUF_SIZE & (UART_RX_BUF_SIZE - 1)) != 0 || UART_RX_BUF_SIZE > 256
+#error "UART_RX_BUF_SIZE must be a power of two not larger than 256"
+#endif
+
+// 帧接收模式下等待处理的帧数量，必须为2的幂
+#define UART_FRAME_QUEUE_SIZE   4
+
+#if (UART_FRAME_QUEUE_SIZE & (UART_FRAME_QUEUE_SIZE - 1)) != 0
+#error "UART_FRAME_QUEUE_SIZE must be a power of two"
+#endif
+
+// 波特率分频表对应的主时钟频率，运行时主时钟不同时自动使用计算方式
+#define UART_FMASTER_HZ         HSI_VALUE
+
+// 分频表中的标准波特率（16MHz下921600误差超过2%，不列入），Tools/test_uart_brr.c按SPL公式逐项核对
+#define UART_BAUD_TABLE(X) \
+    X(9600)                \
+    X(19200)               \
+    X(38400)               \
+    X(57600)               \
+    X(115200)              \
+    X(230400)              \
+    X(460800)
+
+// 分频值及BRR寄存器取值（均为编译期常量），分频值范围16..0xFFFF
+#define UART_BRR_DIV(fmaster, baud) (((fmaster) + (baud) / 2) / (baud))
+#define UART_BRR1(div)              ((uint8_t)((div) >> 4))
+#define UART_BRR2(div)              ((uint8_t)((((div) >> 8) & 0xF0) | ((div) & 0x0F)))
+
+// 串口端口
+typedef enum
+{
+    UART_PORT_1 = 0,    // UART1，控制台
+    UART_PORT_3,        // UART3，RS-485传感器总线
+    UART_PORT_NUM,
+} uart_port_t;
+
+#define UART_CONSOLE_PORT       UART_PORT_1 // printf和shell使用的端口
+#define UART_CONSOLE_BAUDRATE   115200      // 控制台默认波特率，自动波特率未检测到同步字符时使用
+#define UART_CONSOLE_AUTOBAUD   1           // 控制台上电后是否开启自动波特率检测
+
+// 自动波特率：主机重复发送同步字符'U'（0x55）直到收到应答，驱动在RX引脚每个下降沿的外部中断中
+// 记录TIM2计数（按主时钟计数），同步字符5个下降沿之间的8个位时间直接得到分频值，
+// 与标准波特率相差不超过1/16时使用标准值。在此之前端口以原波特率正常收发，
+// 以原波特率收到一个无错误的字节即认为主机使用原波特率，自动结束检测。
+// 下降沿间隔为2个位时间（16MHz下460800时约70个周期），中断处理来不及时漏掉的下降沿使该字符被排除
+#define UART_AUTOBAUD_SYNC      0x55
+#define UART_AUTOBAUD_MIN_BAUD  9600  // 可检测的最低波特率
+#define UART_AUTOBAUD_EDGES     5     // 同步字符的下降沿个数
+#define UART_AUTOBAUD_TIMEOUT_MS 5000 // 开启后这段时间内没有完成检测则结束，保持原波特率
+
+// 低功耗：停机期间串口不工作，由RX引脚下降沿唤醒，唤醒的第一个字节会丢失。
+// 最后一次接收后的这段时间内不停机（只使用WAIT），保证连续输入时不丢字节
+#define UART_PWR_RX_HOLD_MS     10000
+
+// 帧格式，取值即CR1/CR3寄存器位（UART1与UART3相同）
+#define UART_WORDLENGTH_8D      0x00
+#define UART_WORDLENGTH_9D      UART1_CR1_M
+#define UART_PARITY_NO          0x00
+#define UART_PARITY_EVEN        UART1_CR1_PCEN
+#define UART_PARITY_ODD         (UART1_CR1_PCEN | UART1_CR1_PS)
+#define UART_STOPBITS_1         0x00
+#define UART_STOPBITS_2         0x20
+
+// 端口配置
+typedef struct
+{
+    uint32_t baudrate;
+    uint8_t word_length;  // UART_WORDLENGTH_xx，校验位计入字长
+    uint8_t parity;       // UART_PARITY_xx
+    uint8_t stop_bits;    // UART_STOPBITS_xx
+} uart_config_t;
+
+// 发送缓冲区满时的处理策略
+typedef enum
+{
+    UART_TX_BLOCK = 0,  // 等待缓冲区有空间
+    UART_TX_DROP,       // 丢弃新数据
+    UART_TX_OVERWRITE,  // 覆盖最旧的数据
+} uart_tx_policy_t;
+
+// 端口统计
+typedef struct
+{
+    uint8_t tx_high_water;  // 发送缓冲区最高使用量
+    uint16_t tx_dropped;    // 发送丢弃的字节数（DROP/OVERWRITE）
+    uint16_t tx_blocked;    // 因发送缓冲区满而等待的次数（BLOCK）
+    uint16_t rx_dropped;    // 接收缓冲区满丢弃的字节数
+    uint16_t rx_overrun;    // 硬件溢出次数（中断响应不及时）
+    uint16_t rx_noise;      // 噪声错误次数
+    uint16_t rx_framing;    // 帧错误次数（停止位错误，常见于波特率不匹配）
+    uint16_t rx_parity;     // 校验错误次数
+    uint16_t rx_frames;         // 帧接收模式下收到的帧数
+    uint16_t rx_frames_dropped; // 帧队列满丢弃的帧数
+    uint16_t rs485_frames;  // RS-485发送帧数（DE使能/释放次数）
+    uint16_t rs485_turnaround;     // 最近一次最后一个停止位结束到释放DE的时间（us），即中断响应延迟
+    uint16_t rs485_turnaround_max; // 最大转换延迟（us）
+    uint16_t autobaud_miss; // 自动波特率检测中不符合同步字符的下降沿序列数
+} uart_stats_t;
+
+// 自动波特率检测状态
+typedef enum
+{
+    UART_AUTOBAUD_OFF = 0,  // 未开启，或以原波特率收到数据后结束
+    UART_AUTOBAUD_WAIT,     // 等待同步字符
+    UART_AUTOBAUD_DONE,     // 已按同步字符设置波特率
+} uart_autobaud_state_t;
+
+// 接收事件
+#define UART_RX_EVT_THRESHOLD   0x01  // 缓冲数据量达到阈值
+#define UART_RX_EVT_IDLE        0x02  // 线路空闲（一帧数据接收结束）
+
+// 接收事件通知函数，在接收中断中调用
+typedef void (*uart_rx_notify_t)(uint8_t event);
+
+// 帧错误标志：帧内任一字节出错时置位，取值与SR寄存器位相同
+#define UART_FRAME_ERR_PARITY   UART1_SR_PE
+#define UART_FRAME_ERR_FRAMING  UART1_SR_FE
+#define UART_FRAME_ERR_NOISE    UART1_SR_NF
+#define UART_FRAME_ERR_OVERRUN  UART1_SR_OR
+#define UART_FRAME_ERR_TRUNC    0x80  // 接收缓冲区满，帧不完整
+
+// 线路空闲分隔的一帧，数据位于接收缓冲区中，跨越缓冲区末尾时分为两段
+typedef struct
+{
+    const uint8_t *data;
+    uint8_t len;
+    const uint8_t *wrap_data;
+    uint8_t wrap_len;
+    uint8_t flags;          // UART_FRAME_ERR_xx
+} uart_frame_t;
+
+// 端口操作
+void uart_init(uart_port_t port, const uart_config_t *config);
+void uart_deinit(uart_port_t port);
+void uart_set_baudrate(uart_port_t port, uint32_t baudrate);
+void uart_set_divider(uart_port_t port, uint16_t div);
+void uart_set_fmaster(uint32_t fmaster);
+void uart_clk_notify(bsp_clk_event_t event, uint32_t fmaster);
+bool uart_pwr_hook(bsp_pwr_event_t event);
+uint32_t uart_get_baudrate(uart_port_t port);
+void uart_autobaud_start(uart_port_t port);
+void uart_autobaud_stop(uart_port_t port);
+uart_autobaud_state_t uart_autobaud_state(uart_port_t port);
+void uart_write(uart_port_t port, const uint8_t *data, uint16_t len);
+uint8_t uart_read(uart_port_t port, uint8_t *buf, uint8_t len);
+uint8_t uart_rx_count(uart_port_t port);
+void uart_set_rx_notify(uart_port_t port, uart_rx_notify_t notify, uint8_t threshold);
+uint8_t uart_tx_free(uart_port_t port);
+void uart_tx_flush(uart_port_t port);
+void uart_tx_set_policy(uart_port_t port, uart_tx_policy_t policy);
+void uart_get_stats(uart_port_t port, uart_stats_t *stats);
+void uart_set_rs485(uart_port_t port, GPIO_TypeDef *gpio, GPIO_Pin_TypeDef pin);
+void uart_set_frame_mode(uart_port_t port, bool enable);
+bool uart_frame_get(uart_port_t port, uart_frame_t *frame);
+void uart_frame_release(uart_port_t port);
+
+// 控制台端口
 void uart_hw_init(u32 baudrate);
-void uart_set_rx_callback(void (*rx_callback)(uint8_t data));
 void uart_send_byte(uint8_t data);
 void uart_send_bytes(const uint8_t *data, uint16_t len);
+void uart_set_stdout_hook(void (*hook)(const uint8_t *data, uint16_t len));
+void (*uart_get_stdout_hook(void))(const uint8_t *data, uint16_t len);
+void uart_stdout_write(const uint8_t *data, uint16_t len);
 
 #endif
@@ -88,36 +88,36 @@ INTERRUPT_HANDLER(TLI_IRQHandler, 0)
   * @param  None
   * @retval None
   */
-INTERRUPT_HANDLER(AWU_IRQHandler, 1)
-{
+// INTERRUPT_HANDLER(AWU_IRQHandler, 1)
+// {
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
-}
+// }
 
 /**
   * @brief Clock Controller Interrupt routine.
   * @param  None
   * @retval None
   */
-INTERRUPT_HANDLER(CLK_IRQHandler, 2)
-{
+// INTERRUPT_HANDLER(CLK_IRQHandler, 2)
+// {
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
-}
+// }
 
 /**
   * @brief External Interrupt PORTA Interrupt routine.
   * @param  None
   * @retval None
   */
-INTERRUPT_HANDLER(EXTI_PORTA_IRQHandler, 3)
-{
+// INTERRUPT_HANDLER(EXTI_PORTA_IRQHandler, 3)
+// {
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
-}
+// }
 
 /**
   * @brief External Interrupt PORTB Interrupt routine.
@@ -148,12 +148,12 @@ INTERRUPT_HANDLER(EXTI_PORTC_IRQHandler, 5)
   * @param  None
   * @retval None
   */
-INTERRUPT_HANDLER(EXTI_PORTD_IRQHandler, 6)
-{
+// INTERRUPT_HANDLER(EXTI_PORTD_IRQHandler, 6)
+// {
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
-}
+// }
 
 /**
   * @brief External Interrupt PORTE Interrupt routine.
@@ -301,12 +301,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   * @param  None
   * @retval None
   */
- INTERRUPT_HANDLER(TIM3_UPD_OVF_BRK_IRQHandler, 15)
- {
+ // INTERRUPT_HANDLER(TIM3_UPD_OVF_BRK_IRQHandler, 15)
+ // {
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
- }
+ // }
 
 /**
   * @brief Timer3 Capture/Compare Interrupt routine.
@@ -328,12 +328,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   * @param  None
   * @retval None
   */
- INTERRUPT_HANDLER(UART1_TX_IRQHandler, 17)
- {
+// INTERRUPT_HANDLER(UART1_TX_IRQHandler, 17)
+// {
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
- }
+// }
 
 /**
   * @brief UART1 RX Interrupt routine.
@@ -418,24 +418,24 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
   * @param  None
   * @retval None
   */
- INTERRUPT_HANDLER(UART3_TX_IRQHandler, 20)
- {
+// INTERRUPT_HANDLER(UART3_TX_IRQHandler, 20)
+// {
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
- }
+// }
 
 /**
   * @brief UART3 RX interrupt routine.
   * @param  None
   * @retval None
   */
- INTERRUPT_HANDLER(UART3_RX_IRQHandler, 21)
- {
+// INTERRUPT_HANDLER(UART3_RX_IRQHandler, 21)
+// {
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
- }
+// }
 #endif /* (STM8S208) || (STM8S207) || (STM8AF52Ax) || (STM8AF62Ax) */
 
 #if defined(STM8S207) || defined(STM8S007) || defined(STM8S208) || defined (STM8AF52Ax) || defined (STM8AF62Ax)
@@ -484,14 +484,12 @@ INTERRUPT_HANDLER(TIM6_UPD_OVF_TRG_IRQHandler, 23)
   * @param  None
   * @retval None
   */
- INTERRUPT_HANDLER(TIM4_UPD_OVF_IRQHandler, 23)
- {
+// INTERRUPT_HANDLER(TIM4_UPD_OVF_IRQHandler, 23)
+// {
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
-   extern void sys_timer_update_handler(void);
-   sys_timer_update_handler();
- }
+// }
 #endif /* (STM8S903) || (STM8AF622x)*/
 
 /**
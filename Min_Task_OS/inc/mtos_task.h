@@ -25,8 +25,8 @@ typedef struct
 {
     mtos_task_func_t func;      /* 任务函数 */
     mtos_list_node_t list_node; /* 用于挂载到全局链表 */
-    uint16_t time_period;       /* 任务周期 */
-    uint32_t last_run_time;     /* 上次运行时间 */
+    uint32_t time_period;       /* 任务周期（tick） */
+    uint32_t last_run_time;     /* 上次运行时间（tick） */
     uint8_t run_now_flag;       /* 运行标志，设置为1时强制运行 */
     mtos_task_status_t status;  /* 任务状态 */
 } mtos_task_t;
@@ -51,6 +51,29 @@ bool mtos_task_delete(mtos_task_t *task);
  * @return 是否找到并执行了任务
  */
 bool mtos_task_execute_by_name(const char *name);
+bool mtos_task_suspend(const char *name);
+bool mtos_task_resume(const char *name);
+
+/**
+ * @brief 距离下一个周期任务到期的tick数（周期为0的任务不参与）
+ * @return 有任务到期时返回0，没有周期任务时返回BSP_PWR_DEADLINE_NONE
+ */
+uint32_t mtos_task_next_deadline(void);
+/* mtos_task_show/mtos_task_snprint输出的表头 */
+#define MTOS_TASK_SHOW_HEADER "Name       S F   Last Run Period\r\n"
+
+/**
+ * @brief 按序号获取任务
+ * @param index 任务序号（从0开始）
+ * @return 任务指针，序号超出范围返回NULL
+ */
+mtos_task_t *mtos_task_get(uint16_t index);
+
+/**
+ * @brief 格式化任务信息（一行）
+ * @return 写入的字符数
+ */
+int mtos_task_snprint(const mtos_task_t *task, char *buf, uint16_t size);
 void mtos_task_show(void);
 void mtos_task_schedule(void);
 
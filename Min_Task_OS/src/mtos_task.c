@@ -26,7 +26,9 @@ void mtos_init(void)
  * @param name 任务名称
  * @param task 任务函数
  * @param pre_init 任务前置初始化函数
- * @param time_period 任务执行周期
+ * @param time_period 任务执行周期（毫秒），内部换算为系统tick
+ * @note 周期为0的任务每次调度都执行，不参与休眠时间计算（见mtos_task_next_deadline），
+ *       只应处理中断或其他任务产生的事件
  */
 void mtos_task_create(char *name, void (*task)(void), void (*pre_init)(void), uint16_t time_period)
 {
@@ -49,7 +51,7 @@ void mtos_task_create(char *name, void (*task)(void), void (*pre_init)(void), ui
     new_task->func.name = name;
     new_task->func.task_func = task;
     new_task->func.pre_init = pre_init;
-    new_task->time_period = time_period;
+    new_task->time_period = SYS_MS_TO_TICKS(time_period);
     new_task->last_run_time = 0;
     new_task->run_now_flag = 0;
     new_task->status = MTOS_TASK_STATUS_IDLE;
@@ -167,13 +169,125 @@ bool mtos_task_execute_by_name(const char *name)
     return TRUE;
 }
 
+/**
+ * @brief 挂起任务，挂起后不再调度，直到mtos_task_resume或mtos_task_execute_by_name
+ * @param name 任务名称
+ * @return 是否找到任务
+ */
+bool mtos_task_suspend(const char *name)
+{
+    mtos_task_t *task = mtos_task_find_by_name(name);
+
+    if (task == NULL)
+    {
+        return FALSE;
+    }
+    task->status = MTOS_TASK_STATUS_SUSPEND;
+    return TRUE;
+}
+
+/**
+ * @brief 恢复挂起的任务
+ * @param name 任务名称
+ * @return 是否找到任务
+ */
+bool mtos_task_resume(const char *name)
+{
+    mtos_task_t *task = mtos_task_find_by_name(name);
+
+    if (task == NULL)
+    {
+        return FALSE;
+    }
+    if (task->status == MTOS_TASK_STATUS_SUSPEND)
+    {
+        task->status = MTOS_TASK_STATUS_READY;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 距离下一个周期任务到期的tick数，供低功耗管理决定休眠时间
+ * @return 有任务到期或设置了运行标志时返回0，没有周期任务时返回BSP_PWR_DEADLINE_NONE
+ */
+uint32_t mtos_task_next_deadline(void)
+{
+    mtos_list_node_t *node;
+    uint32_t now = sys_timer_get_ticks();
+    uint32_t deadline = BSP_PWR_DEADLINE_NONE;
+    uint32_t elapsed;
+
+    MTOS_LIST_FOR_EACH(&mtos_task_list, node)
+    {
+        mtos_task_t *task = MTOS_LIST_ENTRY(node, mtos_task_t, list_node);
+
+        if (task->status != MTOS_TASK_STATUS_READY)
+        {
+            continue;
+        }
+        if (task->run_now_flag)
+        {
+            return 0;
+        }
+        if (task->time_period == 0)
+        {
+            continue;
+        }
+        elapsed = now - task->last_run_time;
+        if (elapsed >= task->time_period)
+        {
+            return 0;
+        }
+        if (task->time_period - elapsed < deadline)
+        {
+            deadline = task->time_period - elapsed;
+        }
+    }
+    return deadline;
+}
+
+/**
+ * @brief 按序号获取任务
+ * @param index 任务在任务链表中的序号（从0开始）
+ * @return 任务指针，序号超出范围返回NULL
+ */
+mtos_task_t *mtos_task_get(uint16_t index)
+{
+    mtos_list_node_t *node;
+
+    MTOS_LIST_FOR_EACH(&mtos_task_list, node)
+    {
+        if (index-- == 0)
+        {
+            return MTOS_LIST_ENTRY(node, mtos_task_t, list_node);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 格式化任务信息
+ * @param task 任务指针
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @return 写入的字符数
+ */
+int mtos_task_snprint(const mtos_task_t *task, char *buf, uint16_t size)
+{
+    return bsp_snprintf(buf, size, "%-10s %d %d %10lu %5lu\r\n",
+                        task->func.name, task->status, task->run_now_flag,
+                        SYS_TICKS_TO_MS(task->last_run_time), SYS_TICKS_TO_MS(task->time_period));
+}
+
 /**
  * @brief 显示所有任务信息
  */
 void mtos_task_show(void)
 {
     mtos_list_node_t *node;
+    char line[48];
 
+    bsp_printf(MTOS_TASK_SHOW_HEADER);
     // 遍历任务链表
     MTOS_LIST_FOR_EACH(&mtos_task_list, node)
     {
@@ -181,8 +295,8 @@ void mtos_task_show(void)
         mtos_task_t *task = MTOS_LIST_ENTRY(node, mtos_task_t, list_node);
 
         // 打印任务信息
-        printf("MTOS Task Name: %s, Status: %d, Run Now Flag: %d, Last Run Time: %lu, Time Period: %d\r\n",
-               task->func.name, task->status, task->run_now_flag, task->last_run_time, task->time_period);
+        mtos_task_snprint(task, line, sizeof(line));
+        bsp_printf("%s", line);
     }
 }
 
@@ -193,7 +307,7 @@ void mtos_task_show(void)
 void mtos_task_schedule(void)
 {
     mtos_list_node_t *current = mtos_task_list.head;
-    uint32_t current_time = sys_timer_get_system_time_ms();
+    uint32_t current_time = sys_timer_get_ticks(); // 以tick比较，SYS_TICK_HZ较高时也不需要换算
 
     // 遍历任务链表（单向链表兼容）
     while (current != NULL)
@@ -210,8 +324,8 @@ void mtos_task_schedule(void)
             current = next; // 移动到下一个任务
             continue;       // 跳过未就绪或已挂起的任务
         }
-        // 计算任务运行时间，回绕处理
-        uint32_t interval = (current_time >= task->last_run_time) ? (current_time - task->last_run_time) : (current_time + (0xFFFF - task->last_run_time));
+        // 计算任务运行时间，无符号差值在计数回绕时仍然正确
+        uint32_t interval = current_time - task->last_run_time;
 
         // 检查是否需要运行任务（周期到达或强制运行标志设置）
         if (interval >= task->time_period || task->run_now_flag)
@@ -223,7 +337,10 @@ void mtos_task_schedule(void)
                 task->status = MTOS_TASK_STATUS_RUNNING;
                 task->func.task_func();
                 task->last_run_time = current_time;
-                task->status = MTOS_TASK_STATUS_READY;
+                if (task->status == MTOS_TASK_STATUS_RUNNING) // 任务中可能挂起了自己
+                {
+                    task->status = MTOS_TASK_STATUS_READY;
+                }
             }
         }
         // 移动到下一个任务
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+二进制日志解码：从串口或文件读取控制台输出，文本原样输出，日志记录按BSP/log/bsp_log_def.h还原为文本
+
+用法：
+    python bsp_log_decode.py COM3 115200        # 读取串口（需要pyserial）
+    python bsp_log_decode.py capture.bin         # 解码保存的数据
+"""
+
+import os
+import re
+import sys
+
+SYNC = 0xA7
+HEAD_SIZE = 7
+ARGS_MAX = 3
+DEF_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'BSP', 'log', 'bsp_log_def.h')
+
+
+def load_table(path=DEF_FILE):
+    """解析日志定义表，返回[(名称, 模块, 级别, 格式)]，下标即日志编号"""
+    entry = re.compile(r'^\s*X\(\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+    table = []
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            m = entry.match(line)
+            if m:
+                fmt = bytes(m.group(4), 'utf-8').decode('unicode_escape')
+                table.append((m.group(1), m.group(2), m.group(3), fmt))
+    return table
+
+
+def format_record(table, log_id, time_ms, args):
+    name, module, level, fmt = table[log_id]
+    # 设备端格式使用bsp_printf写法，去掉'l'长度修饰后由Python格式化
+    pyfmt = re.sub(r'%([-0]?\d*)l([diuxXc])', r'%\1\2', fmt).replace('%u', '%d')
+    signed = []
+    for conv, value in zip(re.findall(r'%[-0]?\d*l?([diuxXcs])', fmt), args):
+        signed.append(value - (1 << 32) if conv in 'di' and value & 0x80000000 else value)
+    try:
+        text = pyfmt % tuple(signed)
+    except (TypeError, ValueError):
+        text = '%s %s' % (fmt, args)
+    return '[%10.3f] %-5s %-4s %s' % (time_ms / 1000.0, level, module, text)
+
+
+class Decoder:
+    """逐字节解码，记录不合法时把SYNC当作普通文本"""
+
+    def __init__(self, table):
+        self.table = table
+        self.buf = bytearray()
+
+    def feed(self, data):
+        out = []
+        self.buf += data
+        while self.buf:
+            pos = self.buf.find(SYNC)
+            if pos < 0:
+                out.append(self.buf.decode('ascii', 'replace'))
+                self.buf.clear()
+                break
+            if pos > 0:
+                out.append(self.buf[:pos].decode('ascii', 'replace'))
+                del self.buf[:pos]
+            if len(self.buf) < 3:
+                break
+            log_id, length = self.buf[1], self.buf[2]
+            if log_id >= len(self.table) or length % 4 or length > ARGS_MAX * 4:
+                out.append('?')
+                del self.buf[:1]
+                continue
+            if len(self.buf) < HEAD_SIZE + length:
+                break
+            time_ms = int.from_bytes(self.buf[3:7], 'little')
+            args = [int.from_bytes(self.buf[HEAD_SIZE + i:HEAD_SIZE + i + 4], 'little')
+                    for i in range(0, length, 4)]
+            del self.buf[:HEAD_SIZE + length]
+            out.append(format_record(self.table, log_id, time_ms, args) + '\r\n')
+        return ''.join(out)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+    decoder = Decoder(load_table())
+    if os.path.isfile(sys.argv[1]):
+        with open(sys.argv[1], 'rb') as f:
+            sys.stdout.write(decoder.feed(f.read()))
+        return 0
+
+    import serial
+    baudrate = int(sys.argv[2]) if len(sys.argv) > 2 else 115200
+    with serial.Serial(sys.argv[1], baudrate, timeout=0.1) as port:
+        while True:
+            data = port.read(256)
+            if data:
+                sys.stdout.write(decoder.feed(data))
+                sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
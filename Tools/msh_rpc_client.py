@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""
+MSH二进制RPC客户端：按APP/msh/msh_rpc.h的帧格式调用设备命令，并与文本模式对比吞吐量（需要pyserial）
+
+用法：
+    python msh_rpc_client.py COM3 115200 list             # 列出命令表
+    python msh_rpc_client.py COM3 115200 call echo hello  # 调用一条命令，显示状态、返回值和输出
+    python msh_rpc_client.py COM3 115200 bench 200        # 文本模式与RPC模式各执行200次echo，比较每秒命令数
+"""
+
+import sys
+import time
+
+SYNC = 0xA5
+FRAME_MAX = 64
+CMD_LIST = 0xFE
+CMD_EXIT = 0xFF
+STATUS = {0: 'OK', 1: 'ERR_CMD', 2: 'ERR_ARG', 3: 'ERR_TRUNC'}
+PROMPT = b'msh> '
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE，与设备端半字节查表结果相同"""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def build_request(seq, cmd_id, args=()):
+    """请求帧：SYNC LEN SEQ CMD_ID [参数长度 参数]... CRC_L CRC_H"""
+    body = bytearray([seq, cmd_id])
+    for arg in args:
+        if isinstance(arg, str):
+            arg = arg.encode('ascii')
+        body.append(len(arg))
+        body += arg
+    if len(body) > FRAME_MAX:
+        raise ValueError('request longer than %d bytes' % FRAME_MAX)
+    frame = bytearray([len(body)]) + body
+    crc = crc16(frame)
+    return bytes([SYNC]) + bytes(frame) + bytes([crc & 0xFF, crc >> 8])
+
+
+class RpcError(Exception):
+    pass
+
+
+class MshRpc:
+    """在已打开的串口上进入RPC模式并调用命令，超时或CRC错误时以相同SEQ重发（设备不会重复执行）"""
+
+    def __init__(self, port, timeout=0.2, retries=3):
+        self.port = port
+        self.timeout = timeout
+        self.retries = retries
+        self.seq = 0
+        self.ids = {}
+
+    def enter(self):
+        self.port.reset_input_buffer()
+        self.port.write(b'\rrpc\r')
+        read_until(self.port, b'Entering binary RPC mode\r\n', 1.0)
+        names = self.call_id(CMD_LIST)[2].decode('ascii').split('\n')
+        self.ids = {name: i for i, name in enumerate(names) if name}
+
+    def exit(self):
+        self.call_id(CMD_EXIT)
+
+    def call(self, name, *args):
+        """按命令名调用，返回(状态, 返回值, 输出)"""
+        if name not in self.ids:
+            raise RpcError('unknown command %s' % name)
+        return self.call_id(self.ids[name], args)
+
+    def call_id(self, cmd_id, args=()):
+        self.seq = (self.seq + 1) & 0xFF
+        request = build_request(self.seq, cmd_id, args)
+        for _ in range(self.retries):
+            self.port.write(request)
+            reply = self.read_reply()
+            if reply is not None and reply[0] == self.seq:
+                ret = int.from_bytes(reply[2:4], 'little', signed=True)
+                return reply[1], ret, bytes(reply[4:])
+        raise RpcError('no reply to seq %d' % self.seq)
+
+    def read_reply(self):
+        """读取一帧应答，返回LEN之后、CRC之前的数据，超时或CRC错误返回None"""
+        deadline = time.monotonic() + self.timeout
+        while time.monotonic() < deadline:
+            b = self.port.read(1)
+            if not b or b[0] != SYNC:
+                continue
+            head = self.port.read(1)
+            if not head or head[0] < 4 or head[0] > FRAME_MAX:
+                continue
+            rest = self.port.read(head[0] + 2)
+            if len(rest) != head[0] + 2:
+                return None
+            body, crc = rest[:-2], rest[-2] | (rest[-1] << 8)
+            return body if crc16(head + body) == crc else None
+        return None
+
+
+def read_until(port, marker, timeout):
+    data = bytearray()
+    deadline = time.monotonic() + timeout
+    while not data.endswith(marker):
+        if time.monotonic() > deadline:
+            raise RpcError('timeout waiting for %r' % marker)
+        data += port.read(1)
+    return bytes(data)
+
+
+def bench_text(port, count):
+    """文本模式：发送命令行并等待下一个提示符，包含回显、格式化输出和提示符的开销"""
+    port.reset_input_buffer()
+    port.write(b'\r')
+    read_until(port, PROMPT, 1.0)
+    start = time.monotonic()
+    for i in range(count):
+        port.write(b'echo %d\r' % i)
+        read_until(port, PROMPT, 1.0)
+    return count / (time.monotonic() - start)
+
+
+def bench_rpc(rpc, count):
+    start = time.monotonic()
+    for i in range(count):
+        status, _, _ = rpc.call('echo', str(i))
+        if status != 0:
+            raise RpcError('echo failed: %s' % STATUS.get(status, status))
+    return count / (time.monotonic() - start)
+
+
+def main():
+    if len(sys.argv) < 4:
+        print(__doc__)
+        return 1
+    import serial
+    with serial.Serial(sys.argv[1], int(sys.argv[2]), timeout=0.05) as port:
+        action = sys.argv[3]
+        if action == 'bench':
+            count = int(sys.argv[4]) if len(sys.argv) > 4 else 200
+            text = bench_text(port, count)
+            rpc = MshRpc(port)
+            rpc.enter()
+            binary = bench_rpc(rpc, count)
+            rpc.exit()
+            print('text: %8.1f cmd/s' % text)
+            print('rpc:  %8.1f cmd/s  (x%.1f)' % (binary, binary / text))
+            return 0
+
+        rpc = MshRpc(port)
+        rpc.enter()
+        try:
+            if action == 'list':
+                for name, cmd_id in sorted(rpc.ids.items(), key=lambda item: item[1]):
+                    print('%3d %s' % (cmd_id, name))
+            elif action == 'call' and len(sys.argv) > 4:
+                status, ret, out = rpc.call(sys.argv[4], *sys.argv[5:])
+                print('status=%s ret=%d' % (STATUS.get(status, status), ret))
+                sys.stdout.write(out.decode('ascii', 'replace'))
+            else:
+                print(__doc__)
+                return 1
+        finally:
+            rpc.exit()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
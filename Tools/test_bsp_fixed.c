@@ -0,0 +1,225 @@
+/*
+ * BSP/sys/bsp_fixed.c的主机端测试：与double/精确整数参考结果逐位比较
+ *
+ *   - Get_decimal：与原double版本 (u16)((long)(dt*10^deci) % 10^deci) 比较，deci 0~5，
+ *     0附近的输入逐个检查，其余按步长覆盖整个int32范围
+ *   - fixed_to_dec/fixed_from_dec/fixed_split：与double换算（范围内double是精确的）比较
+ *   - fixed_mul/fixed_div：与128位精确结果（向0截断、饱和）比较，边界值加随机输入
+ *   - q15_mul：与四舍五入的精确结果比较
+ *
+ * 直接编译BSP中的源文件，stm8s.h以最小定义代替。编译运行方法见test_common.h
+ */
+
+#include "test_common.h"
+
+// 代替stm8s.h，只提供bsp_fixed用到的类型
+#define __STM8S_H
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef enum {FALSE = 0, TRUE = !FALSE} bool;
+
+#include "../BSP/sys/bsp_fixed.c"
+
+// 原double版本（STM8上long为32位），dt为定点数对应的double值
+static u16 get_decimal_ref(double dt, u8 deci)
+{
+    int32_t x1;
+    u16 x3;
+
+    if (deci > 4) deci = 4;
+    if (deci < 1) deci = 1;
+
+    x3 = (u16)fixed_pow10[deci]; // pow(10, deci)对1~4是精确的
+    x1 = (int32_t)(dt * x3);
+    return (u16)(x1 % x3);
+}
+
+static uint32_t rng_state = 0x12345678UL;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// 随机定点数：按不同量级分布，覆盖不饱和与饱和的情况
+static fixed_t rng_fixed(void)
+{
+    uint32_t r = rng();
+
+    switch (rng() & 3)
+    {
+    case 0:
+        return (fixed_t)r;
+    case 1:
+        return (fixed_t)(int32_t)(int16_t)r; // |x| < 1
+    case 2:
+        return (fixed_t)(r & 0x00FFFFFFUL) * ((r & 0x80000000UL) ? -1 : 1); // |x| < 256
+    default:
+        return (fixed_t)(r >> (rng() & 31)) * ((rng() & 1) ? -1 : 1);
+    }
+}
+
+// 精确值饱和到int32，magnitude为结果绝对值
+static fixed_t saturate(unsigned __int128 magnitude, int negative)
+{
+    if (negative)
+    {
+        return magnitude >= 0x80000000ULL ? FIXED_MIN : -(fixed_t)(int64_t)magnitude;
+    }
+    return magnitude > 0x7FFFFFFFULL ? FIXED_MAX : (fixed_t)(int64_t)magnitude;
+}
+
+static unsigned __int128 mag(int64_t v)
+{
+    return (unsigned __int128)(v < 0 ? -(__int128)v : (__int128)v);
+}
+
+static fixed_t fixed_mul_ref(fixed_t a, fixed_t b)
+{
+    return saturate((mag(a) * mag(b)) >> 16, (a < 0) != (b < 0));
+}
+
+static fixed_t fixed_div_ref(fixed_t a, fixed_t b)
+{
+    if (b == 0)
+    {
+        return a < 0 ? FIXED_MIN : FIXED_MAX;
+    }
+    return saturate((mag(a) << 16) / mag(b), (a < 0) != (b < 0));
+}
+
+static void test_get_decimal(void)
+{
+    int64_t v;
+    u8 deci;
+
+    for (deci = 0; deci <= 5; deci++)
+    {
+        for (v = INT32_MIN; v <= INT32_MAX; v += (v >= -0x1000000 && v < 0x1000000) ? 1 : 4099)
+        {
+            fixed_t dt = (fixed_t)v;
+            u16 got = Get_decimal(dt, deci);
+            u16 ref = get_decimal_ref(dt / 65536.0, deci);
+
+            CHECK(got == ref, "Get_decimal(%ld, %u) = %u, double %u\n", (long)v, deci, got, ref);
+        }
+        CHECK(Get_decimal(FIXED_MAX, deci) == get_decimal_ref(FIXED_MAX / 65536.0, deci), "Get_decimal max\n");
+    }
+}
+
+static void test_decimal_conversion(void)
+{
+    int64_t v;
+    uint8_t n;
+
+    for (n = 0; n <= FIXED_DEC_MAX + 1; n++)
+    {
+        uint8_t dn = n > FIXED_DEC_MAX ? FIXED_DEC_MAX : n;
+        double scale = (double)fixed_pow10[dn];
+
+        for (v = INT32_MIN; v <= INT32_MAX; v += (v >= -0x100000 && v < 0x100000) ? 1 : 65521)
+        {
+            fixed_t x = (fixed_t)v;
+            int32_t dec = fixed_to_dec(x, n);
+            double exact = (double)x / 65536.0 * scale; // |x|*10^4 < 2^53，double精确
+
+            CHECK(dec == (int32_t)exact, "fixed_to_dec(%ld, %u) = %ld, double %.4f\n", (long)v, n, (long)dec, exact);
+
+            // value*65536/10^n，四舍五入（远离0），整数部分超过16位时饱和
+            {
+                double magnitude = (double)(v < 0 ? -v : v) * 65536.0 / scale;
+                uint64_t rounded = (uint64_t)(magnitude + 0.5);
+                fixed_t ref = ((uint64_t)(v < 0 ? -v : v) / fixed_pow10[dn] > 0xFFFF)
+                                  ? (v < 0 ? FIXED_MIN : FIXED_MAX)
+                                  : saturate(rounded, v < 0);
+                fixed_t got = fixed_from_dec((int32_t)v, n);
+
+                CHECK(got == ref, "fixed_from_dec(%ld, %u) = %ld, expected %ld\n", (long)v, n, (long)got, (long)ref);
+            }
+        }
+    }
+
+    for (n = 0; n <= FIXED_POW10_NUM; n++)
+    {
+        uint8_t dn = n >= FIXED_POW10_NUM ? FIXED_POW10_NUM - 1 : n;
+
+        for (v = INT32_MIN; v <= INT32_MAX; v += (v >= -0x10000 && v < 0x10000) ? 1 : 65521)
+        {
+            int32_t integer;
+            uint32_t fraction;
+            int64_t scale = fixed_pow10[dn];
+
+            fixed_split((int32_t)v, n, &integer, &fraction);
+            CHECK(integer == v / scale && fraction == (uint32_t)((v < 0 ? -v : v) % scale),
+                  "fixed_split(%ld, %u) = %ld.%lu\n", (long)v, n, (long)integer, (unsigned long)fraction);
+        }
+    }
+}
+
+static void test_mul_div(void)
+{
+    static const fixed_t edges[] = {
+        0, 1, -1, 2, -2, 0xFFFF, -0xFFFF, FIXED_ONE, -FIXED_ONE, FIXED_ONE + 1, -FIXED_ONE - 1,
+        0x7FFF0000L, -0x7FFF0000L, 0x00FFFFFFL, 0x0100000L, 0x7FFFFFFFL, FIXED_MIN, FIXED_MIN + 1,
+        0x00B504F3L, -0x00B504F3L, 0x00B504F4L, // 约sqrt(32768)，乘积在饱和边界附近
+    };
+    unsigned i;
+    unsigned j;
+    unsigned long k;
+
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    {
+        for (j = 0; j < sizeof(edges) / sizeof(edges[0]); j++)
+        {
+            fixed_t a = edges[i];
+            fixed_t b = edges[j];
+
+            CHECK(fixed_mul(a, b) == fixed_mul_ref(a, b), "fixed_mul(%ld, %ld)\n", (long)a, (long)b);
+            CHECK(fixed_div(a, b) == fixed_div_ref(a, b), "fixed_div(%ld, %ld)\n", (long)a, (long)b);
+        }
+    }
+    for (k = 0; k < 5000000UL; k++)
+    {
+        fixed_t a = rng_fixed();
+        fixed_t b = rng_fixed();
+
+        CHECK(fixed_mul(a, b) == fixed_mul_ref(a, b), "fixed_mul(%ld, %ld) = %ld, expected %ld\n",
+              (long)a, (long)b, (long)fixed_mul(a, b), (long)fixed_mul_ref(a, b));
+        CHECK(fixed_div(a, b) == fixed_div_ref(a, b), "fixed_div(%ld, %ld) = %ld, expected %ld\n",
+              (long)a, (long)b, (long)fixed_div(a, b), (long)fixed_div_ref(a, b));
+    }
+}
+
+static void test_q15(void)
+{
+    int32_t a;
+    int32_t b;
+
+    for (a = INT16_MIN; a <= INT16_MAX; a++)
+    {
+        for (b = INT16_MIN; b <= INT16_MAX; b += (a & 1) ? 251 : 257)
+        {
+            int64_t ref = ((int64_t)a * b + 0x4000) >> 15; // 四舍五入（.5向正方向）
+
+            if (ref > 0x7FFF)
+            {
+                ref = 0x7FFF;
+            }
+            CHECK(q15_mul((int16_t)a, (int16_t)b) == ref, "q15_mul(%ld, %ld)\n", (long)a, (long)b);
+        }
+        CHECK(q15_mul((int16_t)a, INT16_MIN) == (a == INT16_MIN ? 0x7FFF : (((int64_t)a * INT16_MIN + 0x4000) >> 15)),
+              "q15_mul(%ld, -1)\n", (long)a);
+    }
+}
+
+int main(void)
+{
+    test_get_decimal();
+    test_decimal_conversion();
+    test_mul_div();
+    test_q15();
+    return test_report();
+}
@@ -0,0 +1,44 @@
+/*
+ * Tools/test_*.c主机端测试的公共部分：检查宏和结果统计
+ *
+ * 每个测试是一个独立的源文件，直接#include被测的BSP源文件或头文件，被测文件依赖的库头文件
+ * 以预先定义其头文件保护宏的方式代替（-I只用于找到这些文件）。编译运行（仓库根目录，
+ * test_xxx为测试文件名，需要支持__int128的gcc/clang）：
+ *     gcc -O2 -Wall -ILib/inc -IBSP/clk -IBSP/pwr -o /tmp/test_xxx Tools/test_xxx.c && /tmp/test_xxx
+ * 全部通过时退出码为0
+ */
+
+#ifndef __TEST_COMMON_H__
+#define __TEST_COMMON_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_FAIL_PRINT_MAX     20  // 最多打印的失败条数
+
+static unsigned long test_checks;
+static unsigned long test_failures;
+
+// 检查条件，不成立时按printf格式打印原因（格式字符串以换行结尾）
+#define CHECK(cond, ...)                                 \
+    do                                                   \
+    {                                                    \
+        test_checks++;                                   \
+        if (!(cond))                                     \
+        {                                                \
+            if (++test_failures <= TEST_FAIL_PRINT_MAX)  \
+            {                                            \
+                printf("FAIL " __VA_ARGS__);             \
+            }                                            \
+        }                                                \
+    } while (0)
+
+// 打印统计结果，返回值作为main的退出码
+static int test_report(void)
+{
+    printf("%lu checks, %lu failures\n", test_checks, test_failures);
+    return test_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif
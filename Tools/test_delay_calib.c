@@ -0,0 +1,223 @@
+/*
+ * BSP/sys/bsp_sys_delay.c的主机端测试
+ *
+ * 直接编译BSP中的源文件，系统定时器和nop()以模拟代替：模拟时间按主时钟周期计，
+ * 每次nop()为一次延时循环（每次循环的CPU周期数可设），每次读取定时器另加固定的调用开销。
+ * 在不同CPU频率（2/8/16/24MHz）和每次循环周期数下检查
+ *   - delay_us：开/关中断时的实际周期数不短于要求，以TIM3计时时超出不多于两次读取的开销，
+ *     计数低16位回绕时同样正确；只有关中断且接近一次TIM3回绕以上时（及定时器启动前）使用循环
+ *   - delay_calibrate：sys_timer_get_us按1us取整（向下或向上）时，循环延时误差不超过1%加2次循环的时间
+ *   - 测量值过小/过大时每毫秒循环次数饱和而不回绕，循环次数随参数单调不减
+ * 编译运行方法见test_common.h
+ */
+
+#include "test_common.h"
+
+// 代替bsp_sys_pub.h，只提供bsp_sys_delay用到的类型和函数
+#define __BSP_SYS_PUB_H
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef enum {BSP_CLK_EVT_PRE = 0, BSP_CLK_EVT_POST} bsp_clk_event_t;
+#define CPU_CC_I1I0 ((uint8_t)0x28)
+
+#define TEST_CALL_CYCLES    30  // 每次读取定时器的开销
+
+static uint64_t test_loops;     // 已执行的延时循环次数
+static uint64_t test_extra;     // 循环以外经过的周期数
+static unsigned test_loop_cycles = 4;
+static uint8_t test_mhz;        // 0表示系统定时器未启动
+static unsigned test_us_phase;  // 微秒时间戳相对周期计数的相位，用于模拟两种取整
+static int test_masked;         // 是否关中断
+
+#define nop()                   (test_loops++)
+#define __get_interrupt_state() (test_masked ? CPU_CC_I1I0 : 0)
+
+static uint64_t test_now(void)
+{
+    return test_loops * test_loop_cycles + test_extra;
+}
+
+uint8_t sys_timer_get_mhz(void)
+{
+    return test_mhz;
+}
+
+uint32_t sys_timer_get_cycles(void)
+{
+    uint32_t now = (uint32_t)test_now();
+
+    test_extra += TEST_CALL_CYCLES;
+    return now;
+}
+
+uint32_t sys_timer_get_us(void)
+{
+    uint32_t now = (uint32_t)((test_now() + test_us_phase) / test_mhz);
+
+    test_extra += TEST_CALL_CYCLES;
+    return now;
+}
+
+#include "../BSP/sys/bsp_sys_delay.c"
+
+static const uint8_t test_mhz_list[] = {2, 8, 16, 24};
+
+// 各时钟模式下校准后的循环延时精度
+static void test_loop_accuracy(void)
+{
+    static const uint16_t us_list[] = {1, 5, 10, 50, 100, 500, 999, 1000, 1001, 2500, 10000, 65535};
+    unsigned m;
+    unsigned rounding;
+    unsigned i;
+
+    for (m = 0; m < sizeof(test_mhz_list); m++)
+    {
+        double worst = 0;
+
+        test_mhz = test_mhz_list[m];
+        for (test_loop_cycles = 2; test_loop_cycles <= 10; test_loop_cycles++) // 随编译器和优化等级变化
+        {
+            double loop_us = (double)test_loop_cycles / test_mhz;
+
+            for (rounding = 0; rounding < 2; rounding++)
+            {
+                test_us_phase = rounding ? test_mhz - 1 : 0;
+                delay_calibrate();
+                for (i = 0; i < sizeof(us_list) / sizeof(us_list[0]); i++)
+                {
+                    uint64_t start = test_loops;
+                    double actual;
+                    double error;
+                    double limit;
+
+                    delay_us_loop(us_list[i]);
+                    actual = (test_loops - start) * loop_us;
+                    error = actual - us_list[i];
+                    limit = us_list[i] / 100.0 + 2 * loop_us;
+                    CHECK(error <= limit && -error <= limit, "%u MHz, %u cycles/loop, loop delay %u us took %.2f us\n",
+                          test_mhz, test_loop_cycles, us_list[i], actual);
+                    if (us_list[i] >= 1000 && (error < 0 ? -error : error) / us_list[i] > worst)
+                    {
+                        worst = (error < 0 ? -error : error) / us_list[i];
+                    }
+                }
+            }
+        }
+        printf("%2u MHz: worst loop error %.3f%% for delays >= 1 ms\n", test_mhz, worst * 100);
+    }
+}
+
+// delay_us的计时方式和实际周期数，起点覆盖计数低16位回绕前后
+static void test_delay_us(void)
+{
+    static const uint16_t us_list[] = {0, 1, 2, 10, 100, 1000, 2720, 2721, 4080, 4081, 10000, 32640, 32641, 65535};
+    static const uint32_t start_list[] = {0, 0xFFF0, 0x1FFFF, 0xFFFFFF00UL};
+    unsigned m;
+    unsigned i;
+    unsigned s;
+
+    test_loop_cycles = 4;
+    for (m = 0; m < sizeof(test_mhz_list); m++)
+    {
+        test_mhz = test_mhz_list[m];
+        test_us_phase = 0;
+        delay_calibrate();
+        for (test_masked = 0; test_masked <= 1; test_masked++)
+        {
+            for (i = 0; i < sizeof(us_list) / sizeof(us_list[0]); i++)
+            {
+                for (s = 0; s < sizeof(start_list) / sizeof(start_list[0]); s++)
+                {
+                    uint32_t cycles = (uint32_t)us_list[i] * test_mhz;
+                    int use_loop = test_masked && cycles > DELAY_CYCLES_MASKED_MAX;
+                    uint64_t loops;
+                    uint64_t elapsed;
+
+                    test_extra = start_list[s];
+                    test_loops = 0;
+                    delay_us(us_list[i]);
+                    loops = test_loops;
+                    elapsed = test_now() - start_list[s];
+                    CHECK((loops != 0) == use_loop, "%u MHz, masked %d, delay_us(%u): %s used\n", test_mhz,
+                          test_masked, us_list[i], use_loop ? "timer" : "loop");
+                    if (use_loop)
+                    {
+                        CHECK(elapsed * 100 >= (uint64_t)cycles * 99 && elapsed * 100 <= (uint64_t)cycles * 101 + 800,
+                              "%u MHz, masked, delay_us(%u): %lu cycles\n", test_mhz, us_list[i], (unsigned long)elapsed);
+                    }
+                    else
+                    {
+                        CHECK(elapsed >= cycles && elapsed <= cycles + 2 * TEST_CALL_CYCLES,
+                              "%u MHz, masked %d, start %08lX, delay_us(%u): %lu cycles, expected %lu\n", test_mhz,
+                              test_masked, (unsigned long)start_list[s], us_list[i], (unsigned long)elapsed,
+                              (unsigned long)cycles);
+                    }
+                }
+            }
+        }
+    }
+    test_masked = 0;
+
+    // 系统定时器启动之前只能用循环
+    test_mhz = 0;
+    test_loops = 0;
+    delay_us(100);
+    CHECK(test_loops != 0, "delay_us before the timer starts did not use the loop\n");
+}
+
+// 16位边界：测量值使每毫秒循环次数超过/接近65535，或小到不足1次
+static void test_overflow_boundaries(void)
+{
+    uint32_t best;
+    uint32_t prev = 0xFFFFFFFFUL;
+    uint32_t n;
+    uint64_t last;
+
+    for (best = 0; best <= 200000; best = best < 1000 ? best + 1 : best + 997)
+    {
+        uint32_t expect = (uint32_t)DELAY_CALIBRATE_LOOPS * 1000 / (best == 0 ? 1 : best);
+
+        delay_calibrate_set(best);
+        if (expect > 0xFFFF)
+        {
+            expect = 0xFFFF;
+        }
+        CHECK(delay_loops_per_ms == expect, "best %lu: loops/ms %u, expected %lu\n",
+              (unsigned long)best, delay_loops_per_ms, (unsigned long)expect);
+        CHECK(delay_loops_per_ms <= prev, "best %lu: loops/ms not monotonic\n", (unsigned long)best);
+        prev = delay_loops_per_ms;
+    }
+    // 最接近回绕的两个测量值：4000000/62=64516不饱和，4000000/61=65573饱和到65535
+    delay_calibrate_set(62);
+    CHECK(delay_loops_per_ms == 64516, "best 62: loops/ms %u\n", delay_loops_per_ms);
+    delay_calibrate_set(61);
+    CHECK(delay_loops_per_ms == 0xFFFF, "best 61: loops/ms %u\n", delay_loops_per_ms);
+    delay_calibrate_set(DELAY_CALIBRATE_LOOPS * 1000UL + 1);
+    CHECK(delay_loops_per_ms == 1, "too slow: loops/ms %u\n", delay_loops_per_ms);
+
+    // 每毫秒循环次数最大时，Q8系数和每段的循环次数不溢出：循环次数单调不减，且与n微秒相符（误差不超过0.1%）
+    delay_calibrate_set(1);
+    CHECK(delay_loops_per_ms == 0xFFFF && delay_loops_per_us_q8 == 16777, "max: q8 %u\n", delay_loops_per_us_q8);
+    last = 0;
+    for (n = 0; n <= 0xFFFF; n++)
+    {
+        uint64_t start = test_loops;
+        uint64_t loops;
+        uint64_t exact = (uint64_t)n * 0xFFFF / 1000;
+
+        delay_us_loop((uint16_t)n);
+        loops = test_loops - start;
+        CHECK(loops >= last, "delay_us_loop(%lu) loops not monotonic\n", (unsigned long)n);
+        CHECK(loops * 1000 >= exact * 999 && loops * 1000 <= exact * 1001 + 1000, "delay_us_loop(%lu): %lu loops\n",
+              (unsigned long)n, (unsigned long)loops);
+        last = loops;
+    }
+}
+
+int main(void)
+{
+    test_loop_accuracy();
+    test_delay_us();
+    test_overflow_boundaries();
+    return test_report();
+}
@@ -0,0 +1,181 @@
+/*
+ * sys_timer_get_ticks双读算法的主机端压力测试
+ *
+ * STM8按字节（或LDW按16位）读取32位tick计数，tick中断可能发生在任意两次访问之间。
+ * 测试以字节为单位模拟计数的读取，在每一次访问之前的所有位置注入tick，覆盖各个字节进位边界、
+ * 高字节先读/低字节先读、8位/16位访问，检查：
+ *   - 单次读取确实会读到新旧混合的值（测试能发现撕裂）
+ *   - sys_timer_get_ticks的结果总是调用期间计数出现过的某个值，且多次调用单调不减
+ *
+ * 编译运行方法见test_common.h
+ */
+
+#include "test_common.h"
+
+// 模拟的tick计数及中断注入
+static uint32_t sim_ticks;
+static unsigned sim_access;      // 已执行的访问次数
+static unsigned sim_period;      // 每隔多少次访问发生一次tick，0表示只在sim_inject_at注入一次
+static unsigned sim_inject_at;   // 第一次tick发生在第几次访问之前
+static unsigned sim_injected;
+
+// 访问方式
+static int sim_msb_first;        // 高位先读
+static int sim_width;            // 每次访问的字节数，1或2
+
+static void sim_access_hook(void)
+{
+    if (sim_access >= sim_inject_at &&
+        (sim_period == 0 ? sim_access == sim_inject_at : (sim_access - sim_inject_at) % sim_period == 0))
+    {
+        sim_ticks++; // tick中断
+        sim_injected++;
+    }
+    sim_access++;
+}
+
+// 模拟编译器生成的32位读取：分为4/sim_width次访问，每次访问之前都可能发生中断
+static uint32_t sim_read_ticks(void)
+{
+    uint32_t value = 0;
+    int parts = 4 / sim_width;
+    int i;
+
+    for (i = 0; i < parts; i++)
+    {
+        int part = sim_msb_first ? parts - 1 - i : i;
+        int shift = part * sim_width * 8;
+        uint32_t mask = sim_width == 1 ? 0xFFUL : 0xFFFFUL;
+
+        sim_access_hook();
+        value |= ((sim_ticks >> shift) & mask) << shift;
+    }
+    return value;
+}
+
+// 与BSP/timer/sys_timer.c中sys_timer_get_ticks相同的算法
+static uint32_t sys_timer_get_ticks(void)
+{
+    uint32_t value;
+
+    do
+    {
+        value = sim_read_ticks();
+    } while (value != sim_read_ticks());
+    return value;
+}
+
+static const uint32_t test_starts[] = {
+    0x00000000UL, 0x000000FFUL, 0x0000FFFFUL, 0x00FFFFFFUL, 0xFFFFFFFFUL,
+    0x0000FF00UL, 0x00FF00FFUL, 0x7FFFFFFFUL, 0x12FFFFFFUL, 0xFEFFFFFFUL,
+};
+
+#define TEST_START_NUM  (sizeof(test_starts) / sizeof(test_starts[0]))
+
+// 检查并打印当前的模拟参数
+#define CHECK_READ(cond, what, start, got)                                                         \
+    CHECK(cond, "%s: start %08lX, msb_first %d, width %d, inject %u, period %u, got %08lX\n", what, \
+          (unsigned long)(start), sim_msb_first, sim_width, sim_inject_at, sim_period, (unsigned long)(got))
+
+// 单次tick注入在每一个可能的位置：结果必须是注入前或注入后的值
+static void test_single_tick(void)
+{
+    unsigned s;
+    unsigned at;
+
+    for (s = 0; s < TEST_START_NUM; s++)
+    {
+        for (at = 0; at <= 16; at++)
+        {
+            uint32_t got;
+
+            sim_ticks = test_starts[s];
+            sim_access = 0;
+            sim_period = 0;
+            sim_inject_at = at;
+            got = sys_timer_get_ticks();
+            CHECK_READ(got == test_starts[s] || got == test_starts[s] + 1, "single tick", test_starts[s], got);
+        }
+    }
+}
+
+// 周期性tick（间隔远大于一次双读时tick之间至少100us），连续调用：结果在调用期间的取值范围内且单调
+static void test_periodic_ticks(void)
+{
+    unsigned s;
+    unsigned period;
+    unsigned phase;
+    int call;
+
+    for (s = 0; s < TEST_START_NUM; s++)
+    {
+        for (period = 9; period <= 40; period++)
+        {
+            for (phase = 0; phase < period; phase++)
+            {
+                uint32_t last;
+
+                sim_ticks = test_starts[s] - 3;
+                sim_access = 0;
+                sim_period = period;
+                sim_inject_at = phase;
+                last = sim_ticks;
+                for (call = 0; call < 64; call++)
+                {
+                    uint32_t before = sim_ticks;
+                    uint32_t got = sys_timer_get_ticks();
+                    uint32_t after = sim_ticks;
+
+                    CHECK_READ(got - before <= after - before, "value outside call window", before, got);
+                    CHECK_READ(got - last < 0x80000000UL, "not monotonic", last, got);
+                    last = got;
+                }
+            }
+        }
+    }
+}
+
+// 对照：不做双读时单次读取会撕裂，说明上面的测试确实覆盖了字节之间的中断
+static unsigned count_torn_single_reads(void)
+{
+    unsigned s;
+    unsigned at;
+    unsigned torn = 0;
+
+    for (s = 0; s < TEST_START_NUM; s++)
+    {
+        for (at = 0; at < 4; at++)
+        {
+            uint32_t got;
+
+            sim_ticks = test_starts[s];
+            sim_access = 0;
+            sim_period = 0;
+            sim_inject_at = at;
+            got = sim_read_ticks();
+            if (got != test_starts[s] && got != test_starts[s] + 1)
+            {
+                torn++;
+            }
+        }
+    }
+    return torn;
+}
+
+int main(void)
+{
+    unsigned torn = 0;
+
+    for (sim_width = 1; sim_width <= 2; sim_width++)
+    {
+        for (sim_msb_first = 0; sim_msb_first <= 1; sim_msb_first++)
+        {
+            torn += count_torn_single_reads();
+            test_single_tick();
+            test_periodic_ticks();
+        }
+    }
+    CHECK(torn != 0, "harness: single reads never tore, tick injection is not effective\n");
+    printf("%u torn single reads detected, %u ticks injected\n", torn, sim_injected);
+    return test_report();
+}
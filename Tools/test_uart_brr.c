@@ -0,0 +1,145 @@
+/*
+ * BSP/uart/bsp_uart.h波特率分频表的主机端测试
+ *
+ * 展开UART_BAUD_TABLE，对每个主时钟频率（HSI 16/8/2MHz，HSE 24MHz）和每个表项，
+ * 把UART_BRR1/UART_BRR2的取值与SPL的UART1_Init公式比较，检查
+ *   - BRR1/BRR2编码：分频值16..0xFFFF按uart_get_baudrate的方式解码后不变
+ *   - 分频值是最接近的整数，误差不大于SPL（SPL两次截断，分频值可能偏小1~2）
+ *   - 分频值不同时BRR1/BRR2与SPL相差的只是分频值的差
+ *   - UART_FMASTER_HZ下（编译期分频表）每个表项的分频值在16..0xFFFF内且误差不超过2%
+ * 其他主时钟下分频值小于16的波特率硬件不支持，只列出不检查。
+ * 编译运行方法见test_common.h
+ */
+
+#include "test_common.h"
+
+// 代替stm8s.h、bsp_clk.h、bsp_pwr.h（预先定义头文件保护宏），只提供bsp_uart.h用到的类型
+#define __STM8S_H
+#define __BSP_CLK_H__
+#define __BSP_PWR_H__
+#define HSI_VALUE   ((uint32_t)16000000)
+#define HSE_VALUE   ((uint32_t)24000000)
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef enum {FALSE = 0, TRUE = !FALSE} bool;
+typedef struct gpio GPIO_TypeDef;
+typedef uint8_t GPIO_Pin_TypeDef;
+typedef uint8_t bsp_clk_event_t;
+typedef uint8_t bsp_pwr_event_t;
+
+#include "../BSP/uart/bsp_uart.h"
+
+#define TEST_BAUD(baud) baud,
+static const uint32_t test_bauds[] = {UART_BAUD_TABLE(TEST_BAUD)};
+
+#define TEST_BAUD_NUM   (sizeof(test_bauds) / sizeof(test_bauds[0]))
+
+// 与uart_get_baudrate相同的解码：BRR2高4位为DIV[15:12]，BRR1为DIV[11:4]，BRR2低4位为DIV[3:0]
+static uint16_t brr_decode(uint8_t brr1, uint8_t brr2)
+{
+    return (uint16_t)(((uint16_t)(brr2 & 0xF0) << 8) | ((uint16_t)brr1 << 4) | (brr2 & 0x0F));
+}
+
+// Lib/src/stm8s_uart1.c中UART1_Init的分频计算（32位运算）
+static void spl_brr(uint32_t fmaster, uint32_t baudrate, uint8_t *brr1, uint8_t *brr2)
+{
+    uint32_t mantissa = fmaster / (baudrate << 4);
+    uint32_t mantissa100 = (fmaster * 100) / (baudrate << 4);
+
+    *brr2 = (uint8_t)((uint8_t)(((mantissa100 - (mantissa * 100)) << 4) / 100) & (uint8_t)0x0F);
+    *brr2 |= (uint8_t)((mantissa >> 4) & (uint8_t)0xF0);
+    *brr1 = (uint8_t)mantissa;
+}
+
+// 分频值对应的波特率相对误差（%）
+static double brr_error(uint32_t fmaster, uint32_t baudrate, uint16_t div)
+{
+    return ((double)fmaster / div - baudrate) * 100.0 / baudrate;
+}
+
+static double error_abs(double error)
+{
+    return error < 0 ? -error : error;
+}
+
+static void test_encoding(void)
+{
+    uint32_t div;
+
+    for (div = 16; div <= 0xFFFF; div++)
+    {
+        CHECK(brr_decode(UART_BRR1(div), UART_BRR2(div)) == div, "div %lu encodes as BRR1 %02X BRR2 %02X\n",
+              (unsigned long)div, UART_BRR1(div), UART_BRR2(div));
+    }
+}
+
+static void test_table(void)
+{
+    static const struct
+    {
+        const char *name;
+        uint32_t fmaster;
+    } clocks[] = {
+        {"HSI", HSI_VALUE},
+        {"HSI/2", HSI_VALUE / 2},
+        {"HSI/8", HSI_VALUE / 8},
+        {"HSE", HSE_VALUE},
+    };
+    unsigned c;
+    unsigned i;
+
+    for (c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        uint32_t f = clocks[c].fmaster;
+
+        printf("%-5s %8lu Hz    baud  div(spl)  BRR1 BRR2 (spl)    error   (spl)\n", clocks[c].name, (unsigned long)f);
+        for (i = 0; i < TEST_BAUD_NUM; i++)
+        {
+            uint32_t b = test_bauds[i];
+            uint32_t div = UART_BRR_DIV(f, b);
+            uint8_t brr1 = UART_BRR1(div);
+            uint8_t brr2 = UART_BRR2(div);
+            uint8_t spl1;
+            uint8_t spl2;
+            uint16_t spl_div;
+            double error;
+            double spl_error;
+
+            spl_brr(f, b, &spl1, &spl2);
+            spl_div = brr_decode(spl1, spl2);
+            if (div < 16)
+            {
+                printf("%24lu  %3lu  unsupported (divider below 16)\n", (unsigned long)b, (unsigned long)div);
+                CHECK(f != UART_FMASTER_HZ, "table baud %lu has divider %lu\n", (unsigned long)b, (unsigned long)div);
+                continue;
+            }
+            error = brr_error(f, b, (uint16_t)div);
+            spl_error = brr_error(f, b, spl_div);
+            printf("%24lu %5lu(%5u)  %02X   %02X   (%02X %02X) %+7.3f%% (%+7.3f%%)\n", (unsigned long)b,
+                   (unsigned long)div, spl_div, brr1, brr2, spl1, spl2, error, spl_error);
+
+            CHECK(div <= 0xFFFF, "%lu Hz, baud %lu: divider %lu\n", (unsigned long)f, (unsigned long)b, (unsigned long)div);
+            CHECK((uint64_t)div * b <= (uint64_t)f + b / 2 && (uint64_t)div * b + b / 2 >= f,
+                  "%lu Hz, baud %lu: divider %lu is not the nearest\n", (unsigned long)f, (unsigned long)b,
+                  (unsigned long)div);
+            CHECK(error_abs(error) <= error_abs(spl_error) + 1e-9, "%lu Hz, baud %lu: error %.3f%%, SPL %.3f%%\n",
+                  (unsigned long)f, (unsigned long)b, error, spl_error);
+            CHECK(div >= spl_div && div - spl_div <= 2, "%lu Hz, baud %lu: divider %lu, SPL %u\n", (unsigned long)f,
+                  (unsigned long)b, (unsigned long)div, spl_div);
+            CHECK(div != spl_div || (brr1 == spl1 && brr2 == spl2), "%lu Hz, baud %lu: BRR %02X %02X, SPL %02X %02X\n",
+                  (unsigned long)f, (unsigned long)b, brr1, brr2, spl1, spl2);
+            if (f == UART_FMASTER_HZ)
+            {
+                CHECK(error_abs(error) <= 2.0, "table baud %lu: error %.3f%%\n", (unsigned long)b, error);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    test_encoding();
+    test_table();
+    return test_report();
+}